@@ -0,0 +1,57 @@
+-- Initial Lua Script
+print("Hello from Lua 5.1!")
+
+-- Let's try to create an entity
+local id = Engine.CreateEntity()
+print("Created entity with ID: " .. id)
+
+-- Let's play a sound (resolved once, then played by ID)
+local boing = Engine.LoadSound("./assets/snd/boing.wav")
+Engine.PlaySound(boing)
+
+-- Sandbox verification
+if os then
+    print("Warning: 'os' library is available!")
+else
+    print("Sandbox Verified: 'os' library is NOT available.")
+end
+
+if dofile then
+    print("Warning: 'dofile' is available!")
+else
+    print("Sandbox Verified: 'dofile' is NOT available.")
+end
+
+-- Per-frame logic: on_update(dt) runs once per frame, and a behaviour
+-- runs once per frame for its entity, with a 'self' table that keeps its
+-- state. dt is in seconds.
+local spin = 1 -- Direction of the spinner below, flipped every 4 seconds
+local elapsed = 0
+function on_update(dt)
+    elapsed = elapsed + dt
+    if elapsed >= 4 then
+        elapsed = elapsed - 4
+        spin = -spin
+    end
+end
+
+-- A ball that steers itself in circles (velocity is in pixels per frame)
+local spinner = Engine.CreateEntity()
+Engine.SetPosition(spinner, 224, 80)
+Engine.LoadAsync("sprite", "./assets/spr/testball.pbm", "urgent",
+    function(handle, ok)
+        if not ok then return end
+        Engine.SetSprite(spinner, "./assets/spr/testball.pbm")
+        Engine.SetBehaviour(spinner, function(self, dt)
+            self.angle = (self.angle or 0) + spin * 2 * dt
+            Engine.SetVelocity(self.id, 3 * math.cos(self.angle),
+                               3 * math.sin(self.angle))
+        end)
+    end)
+
+-- Time check
+local t = Engine.GetTime()
+print("Current Time: " .. t .. " seconds")
+
+-- Set Background
+Engine.SetBackgroundImage("./assets/bkg/testbackground.pbm")
@@ -0,0 +1,2 @@
+#!/bin/bash
+cd .. && make audiobench && ./bin/audiobench 256 10
@@ -0,0 +1,2 @@
+#!/bin/bash
+cd .. && make clean && make dist platform=headless optimize=1 warnings=1 && MONOTEST_FRAMES=600 MONOTEST_AUDIO_OUT=dist/headless.wav ./dist/monotest
@@ -0,0 +1,42 @@
+-- Initial Lua Script
+print("Hello from Lua 5.1!")
+
+-- Let's try to create an entity
+local id = Engine.CreateEntity()
+print("Created entity with ID: " .. id)
+
+-- Let's play a sound (resolved once, then played by ID)
+local boing = Engine.LoadSound("./assets/snd/boing.wav")
+Engine.PlaySound(boing)
+
+-- Sandbox verification
+if os then
+    print("Warning: 'os' library is available!")
+else
+    print("Sandbox Verified: 'os' library is NOT available.")
+end
+
+if dofile then
+    print("Warning: 'dofile' is available!")
+else
+    print("Sandbox Verified: 'dofile' is NOT available.")
+end
+
+-- Per-frame logic: on_update(dt) runs once per frame, and a behaviour
+-- runs once per frame for its entity, with a 'self' table that keeps its
+-- state. dt is in seconds.
+function on_update(dt)
+end
+
+Engine.SetBehaviour(id, function(self, dt)
+    self.angle = (self.angle or 0) + dt
+    Engine.SetPosition(self.id, 240 + 60 * math.cos(self.angle),
+                       160 + 60 * math.sin(self.angle))
+end)
+
+-- Time check
+local t = Engine.GetTime()
+print("Current Time: " .. t .. " seconds")
+
+-- Set Background
+Engine.SetBackgroundImage("./assets/bkg/testbackground.pbm")
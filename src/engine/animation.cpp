@@ -0,0 +1,69 @@
+#include "animation.h"
+#include "ecs.h"
+#include "engine.h"
+
+// --- Helper: Point an entity's drawable at a frame ---
+static void ApplyFrame(Registry &registry, Engine &engine, EntityID owner,
+                       const AnimationFrame &frame) {
+  DrawableComponent *ref = registry.get_drawable_ref(owner);
+  if (!ref)
+    return;
+
+  int index = ref->drawable_index;
+  switch (ref->type) {
+  case DrawableType::BACKGROUND:
+    if (index >= 0 && index < engine.background_drawables_count) {
+      engine.background_drawables[index].sprite = frame.sprite;
+      engine.background_drawables[index].mask = frame.mask;
+    }
+    break;
+  case DrawableType::WORLD:
+    if (index >= 0 && index < engine.world_drawables_count) {
+      engine.world_drawables[index].sprite = frame.sprite;
+      engine.world_drawables[index].mask = frame.mask;
+    }
+    break;
+  case DrawableType::FOREGROUND:
+    if (index >= 0 && index < engine.foreground_drawables_count) {
+      engine.foreground_drawables[index].sprite = frame.sprite;
+      engine.foreground_drawables[index].mask = frame.mask;
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+void UpdateAnimators(Registry &registry, Engine &engine) {
+  AnimatorComponent *animators = registry.animators_data();
+  int count = registry.animators_count();
+
+  for (int i = 0; i < count; i++) {
+    AnimatorComponent &a = animators[i];
+    if (!a.playing)
+      continue;
+
+    // Most ticks only count down
+    if (a.ticks_left > 1) {
+      a.ticks_left--;
+      continue;
+    }
+
+    const AnimationClip *clip = a.clip;
+
+    // ticks_left == 0 means "just started": show the current frame as-is
+    if (a.ticks_left == 1) {
+      if (a.frame + 1 < clip->frame_count) {
+        a.frame++;
+      } else if (clip->flags & ANIM_FLAG_LOOP) {
+        a.frame = 0;
+      } else {
+        a.playing = false; // Hold the last frame
+        continue;
+      }
+    }
+
+    a.ticks_left = (uint16_t)clip->ticks_per_frame;
+    ApplyFrame(registry, engine, a.owner, clip->frames[a.frame]);
+  }
+}
@@ -0,0 +1,37 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "sprite.h"
+#include <stdint.h>
+
+// --- Clip Flags ---
+#define ANIM_FLAG_LOOP (1 << 0) // Wrap to frame 0 instead of holding the last
+
+typedef struct {
+  Sprite *sprite;
+  Sprite *mask;
+} AnimationFrame;
+
+// An animation clip, sliced from a horizontal frame strip at load time.
+// The clip header, its frame table and every frame's sprite (and mask) are
+// allocated back to back from the SpriteArena, so stepping through a clip
+// walks one contiguous block.
+// Timing is in game ticks (one Game::update), which keeps it deterministic.
+typedef struct __attribute__((aligned(8))) AnimationClip {
+  int16_t frame_count;
+  int16_t ticks_per_frame;
+  uint32_t flags;
+
+  // Flexible Array Member: frame_count entries
+  AnimationFrame frames[];
+} AnimationClip;
+
+class Registry;
+class Engine;
+
+// The animation system. Advances every AnimatorComponent by one tick in a
+// single pass over the dense animator array, and only touches a drawable
+// (its sprite / mask pointers) when the frame actually changes.
+void UpdateAnimators(Registry &registry, Engine &engine);
+
+#endif // ANIMATION_H
@@ -0,0 +1,118 @@
+#include "animationfileloader.h"
+#include "pbm.h"
+#include "spritefileloader.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// --- Helper: Load a whole strip into its own scratch arena ---
+// Only the sliced frames are kept in the caller's arena.
+static Sprite *LoadScratchStrip(SpriteArena *scratch, const char *filename) {
+  std::ifstream fs(filename, std::ios::binary | std::ios::ate);
+  if (!fs) {
+    std::cerr << "Error: Could not open file " << filename << std::endl;
+    return nullptr;
+  }
+  size_t file_size = (size_t)fs.tellg();
+  fs.close();
+
+  size_t capacity = sizeof(Sprite) + PBM_MaxPixelBytes(file_size) + 4;
+  if (!Arena_Init(scratch, "Scratch arena", capacity, ARENA_BACKING_HEAP))
+    return nullptr;
+
+  return LoadSpritePBM(scratch, filename);
+}
+
+// --- Helper: Copy one frame's columns out of the strip ---
+static void SliceFrame(Sprite *dst, const Sprite *strip, int frame,
+                       int frame_words) {
+  dst->width = (int16_t)(frame_words * 32);
+  dst->height = strip->height;
+  dst->width_in_words = frame_words;
+  dst->flags = 0;
+
+  for (int y = 0; y < strip->height; y++) {
+    memcpy(dst->pixels + y * frame_words,
+           strip->pixels + y * strip->width_in_words + frame * frame_words,
+           frame_words * sizeof(uint32_t));
+  }
+}
+
+AnimationClip *LoadAnimationStripPBM(SpriteArena *arena, const char *filename,
+                                     const char *mask_filename,
+                                     int frame_width, int ticks_per_frame,
+                                     uint32_t flags) {
+  if (frame_width <= 0 || frame_width % 32 != 0) {
+    std::cerr << "Error: Animation " << filename << " frame width ("
+              << frame_width << ") is not a multiple of 32." << std::endl;
+    return nullptr;
+  }
+
+  // 1. Load the strip (and optional mask strip) into scratch memory
+  SpriteArena strip_scratch = {};
+  SpriteArena mask_scratch = {};
+
+  Sprite *strip = LoadScratchStrip(&strip_scratch, filename);
+  Sprite *mask_strip = nullptr;
+  if (strip && mask_filename) {
+    mask_strip = LoadScratchStrip(&mask_scratch, mask_filename);
+    if (mask_strip && (mask_strip->width != strip->width ||
+                       mask_strip->height != strip->height)) {
+      std::cerr << "Error: Animation mask " << mask_filename
+                << " does not match the size of " << filename << std::endl;
+      mask_strip = nullptr;
+    }
+  }
+
+  AnimationClip *clip = nullptr;
+  int frame_count = strip ? strip->width / frame_width : 0;
+
+  if (strip && (!mask_filename || mask_strip) && frame_count > 0) {
+    // 2. One block: header, frame table, then sprite / mask pairs.
+    // The sprite used as the mask carries a span table.
+    int frame_words = frame_width / 32;
+    size_t frame_bytes =
+        sizeof(Sprite) + (size_t)frame_words * 4 * strip->height;
+    size_t mask_bytes = frame_bytes + Sprite_SpansBytes(strip->height);
+    size_t header_bytes =
+        sizeof(AnimationClip) + frame_count * sizeof(AnimationFrame);
+    header_bytes = (header_bytes + 3) & ~(size_t)3;
+    size_t per_frame = mask_strip ? frame_bytes + mask_bytes : mask_bytes;
+
+    uint8_t *block = (uint8_t *)Arena_Alloc(
+        arena, header_bytes + per_frame * frame_count, 8);
+
+    if (block) {
+      clip = (AnimationClip *)block;
+      clip->frame_count = (int16_t)frame_count;
+      clip->ticks_per_frame = (int16_t)(ticks_per_frame > 0 ? ticks_per_frame
+                                                            : 1);
+      clip->flags = flags;
+
+      // 3. Slice the frames
+      uint8_t *cursor = block + header_bytes;
+      for (int f = 0; f < frame_count; f++) {
+        Sprite *frame = (Sprite *)cursor;
+        SliceFrame(frame, strip, f, frame_words);
+        cursor += mask_strip ? frame_bytes : mask_bytes;
+
+        Sprite *mask = frame;
+        if (mask_strip) {
+          mask = (Sprite *)cursor;
+          SliceFrame(mask, mask_strip, f, frame_words);
+          cursor += mask_bytes;
+        }
+        BuildSpriteSpans(mask);
+
+        clip->frames[f].sprite = frame;
+        clip->frames[f].mask = mask;
+      }
+    }
+  }
+
+  Arena_Release(&strip_scratch);
+  Arena_Release(&mask_scratch);
+  return clip;
+}
@@ -0,0 +1,16 @@
+#ifndef ANIMATIONFILELOADER_H
+#define ANIMATIONFILELOADER_H
+
+#include "animation.h"
+#include "spritearena.h"
+
+// Loads a horizontal frame strip (PBM, see pbm.h) and slices it into an
+// AnimationClip allocated from the provided arena. frame_width must be a
+// multiple of 32. If mask_filename is nullptr, every frame is its own mask.
+// Returns nullptr on failure (file not found, format error, out of memory).
+AnimationClip *LoadAnimationStripPBM(SpriteArena *arena, const char *filename,
+                                     const char *mask_filename,
+                                     int frame_width, int ticks_per_frame,
+                                     uint32_t flags);
+
+#endif // ANIMATIONFILELOADER_H
@@ -0,0 +1,183 @@
+#include "arena.h"
+#include "thread.h"
+#include <cstdlib>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+static const size_t PAGE_SIZE_GUESS = 4096;
+
+// --- Helper: Map anonymous memory, optionally asking for huge pages ---
+// Returns nullptr on failure; *mapped_size receives the rounded size.
+static uint8_t *MapMemory(size_t capacity, bool huge, size_t *mapped_size) {
+  size_t granule = huge ? HUGE_PAGE_SIZE : PAGE_SIZE_GUESS;
+  size_t size = (capacity + granule - 1) & ~(granule - 1);
+  *mapped_size = size;
+
+#ifdef _WIN32
+  // Large pages need SeLockMemoryPrivilege, which games rarely have, so
+  // Windows always uses regular pages.
+  void *p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT,
+                         PAGE_READWRITE);
+  return (uint8_t *)p;
+#else
+  void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  // 1. Explicit huge pages (only if the system has some reserved)
+  if (huge) {
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+
+  // 2. Regular mapping, with a transparent huge page hint
+  if (p == MAP_FAILED) {
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+             -1, 0);
+    if (p == MAP_FAILED)
+      return nullptr;
+#ifdef MADV_HUGEPAGE
+    if (huge)
+      madvise(p, size, MADV_HUGEPAGE);
+#endif
+  }
+  return (uint8_t *)p;
+#endif
+}
+
+static void UnmapMemory(uint8_t *base, size_t mapped_size) {
+#ifdef _WIN32
+  (void)mapped_size;
+  VirtualFree(base, 0, MEM_RELEASE);
+#else
+  munmap(base, mapped_size);
+#endif
+}
+
+bool Arena_Init(Arena *arena, const char *name, size_t capacity,
+                uint32_t backing) {
+  arena->base_memory = nullptr;
+  arena->bytes_used = 0;
+  arena->capacity = 0;
+  arena->high_water = 0;
+  arena->alloc_count = 0;
+  arena->backing = ARENA_BACKING_HEAP;
+  arena->mapped_size = 0;
+  arena->name = name ? name : "Arena";
+  arena->lock = nullptr;
+
+  // 1. Mapped backing, if requested
+  if (backing == ARENA_BACKING_MMAP || backing == ARENA_BACKING_HUGEPAGES) {
+    size_t mapped_size = 0;
+    uint8_t *base = MapMemory(capacity, backing == ARENA_BACKING_HUGEPAGES,
+                              &mapped_size);
+    if (base) {
+      arena->base_memory = base;
+      arena->capacity = capacity;
+      arena->backing = backing;
+      arena->mapped_size = mapped_size;
+      return true;
+    }
+    std::cerr << "Warning: " << arena->name
+              << " could not be mapped, using the heap." << std::endl;
+  }
+
+  // 2. Heap
+  arena->base_memory = (uint8_t *)malloc(capacity);
+  if (!arena->base_memory) {
+    std::cerr << "Error: " << arena->name << " could not allocate " << capacity
+              << " bytes!" << std::endl;
+    return false;
+  }
+  arena->capacity = capacity;
+  return true;
+}
+
+void Arena_Release(Arena *arena) {
+  if (arena->base_memory) {
+    if (arena->backing == ARENA_BACKING_HEAP) {
+      free(arena->base_memory);
+    } else {
+      UnmapMemory(arena->base_memory, arena->mapped_size);
+    }
+  }
+
+  arena->base_memory = nullptr;
+  arena->bytes_used = 0;
+  arena->capacity = 0;
+}
+
+// --- Helper: Unlocked bump allocation ---
+static void *AllocUnlocked(Arena *arena, size_t size, size_t align) {
+  // 1. Calculate current address
+  uintptr_t current_ptr = (uintptr_t)(arena->base_memory + arena->bytes_used);
+
+  // 2. Calculate alignment offset
+  size_t offset = 0;
+  if (align > 0) {
+    size_t modulo = current_ptr & (align - 1);
+    if (modulo != 0) {
+      offset = align - modulo;
+    }
+  }
+
+  // 3. Check capacity
+  if (arena->bytes_used + offset + size > arena->capacity) {
+    std::cerr << "Error: " << arena->name << " out of memory!" << std::endl;
+    return nullptr;
+  }
+
+  // 4. Update usage and return aligned pointer
+  arena->bytes_used += offset;
+  void *result = arena->base_memory + arena->bytes_used;
+  arena->bytes_used += size;
+
+  if (arena->bytes_used > arena->high_water)
+    arena->high_water = arena->bytes_used;
+  arena->alloc_count++;
+
+  return result;
+}
+
+void *Arena_Alloc(Arena *arena, size_t size, size_t align) {
+  if (!arena->lock)
+    return AllocUnlocked(arena, size, align);
+
+  MutexLock guard(arena->lock);
+  return AllocUnlocked(arena, size, align);
+}
+
+ArenaCheckpoint Arena_Checkpoint(const Arena *arena) {
+  if (!arena->lock)
+    return arena->bytes_used;
+
+  MutexLock guard(arena->lock);
+  return arena->bytes_used;
+}
+
+void Arena_Rewind(Arena *arena, ArenaCheckpoint checkpoint) {
+  if (arena->lock)
+    Mutex_Lock(arena->lock);
+
+  if (checkpoint > arena->bytes_used) {
+    std::cerr << "Error: " << arena->name
+              << " rewound to a checkpoint past its end!" << std::endl;
+  } else {
+    arena->bytes_used = checkpoint;
+  }
+
+  if (arena->lock)
+    Mutex_Unlock(arena->lock);
+}
+
+void Arena_PrintStats(const Arena *arena) {
+  std::cout << arena->name << ": " << arena->bytes_used / 1024 << " KB used, "
+            << arena->high_water / 1024 << " KB peak, "
+            << arena->capacity / 1024 << " KB capacity, "
+            << arena->alloc_count << " allocations" << std::endl;
+}
@@ -0,0 +1,70 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Linear (bump) allocator shared by every asset type.
+// Allocation is a pointer bump; nothing is freed individually. Instead a
+// checkpoint is taken before a batch of loads (e.g. a level) and the arena is
+// rewound to it afterwards, which frees the whole batch in O(1).
+
+// Backing store, chosen at Arena_Init
+#define ARENA_BACKING_HEAP 0      // malloc
+#define ARENA_BACKING_MMAP 1      // Anonymous mapping (VirtualAlloc on Win32)
+#define ARENA_BACKING_HUGEPAGES 2 // Mapping backed by 2 MB pages if possible
+
+typedef struct Arena {
+  uint8_t *base_memory; // Pointer to the start of the block
+  size_t bytes_used;    // How much we have filled so far
+  size_t capacity;      // Total size
+
+  // Statistics
+  size_t high_water;   // Largest bytes_used ever reached
+  uint32_t alloc_count; // Allocations since init
+
+  uint32_t backing;   // ARENA_BACKING_*
+  size_t mapped_size; // Bytes actually mapped (rounded to the page size)
+  const char *name;   // Used in error messages and stats
+
+  // Optional. When set, Arena_Alloc, Arena_Checkpoint and Arena_Rewind take
+  // it, so loader threads can reserve memory while the main thread loads too.
+  struct Mutex *lock;
+} Arena;
+
+// Position in an arena to rewind to later
+typedef size_t ArenaCheckpoint;
+
+// Reserves 'capacity' bytes. Hugepages fall back to a regular mapping, and a
+// failed mapping falls back to the heap. Returns false if no memory could be
+// obtained at all.
+bool Arena_Init(Arena *arena, const char *name, size_t capacity,
+                uint32_t backing);
+
+// Returns the backing memory.
+void Arena_Release(Arena *arena);
+
+// Returns 'size' bytes aligned to 'align' (power of two, or 0 for none),
+// or nullptr when the arena is full.
+void *Arena_Alloc(Arena *arena, size_t size, size_t align);
+
+// Current position, taken under the arena's lock if it has one.
+ArenaCheckpoint Arena_Checkpoint(const Arena *arena);
+
+// Frees everything allocated after 'checkpoint', by any thread: on a locked
+// arena, stop the other allocators first (see AssetLoader_Drain).
+void Arena_Rewind(Arena *arena, ArenaCheckpoint checkpoint);
+
+// True if 'ptr' was allocated after 'checkpoint' and is still live
+static inline bool Arena_OwnsSince(const Arena *arena,
+                                   ArenaCheckpoint checkpoint,
+                                   const void *ptr) {
+  const uint8_t *p = (const uint8_t *)ptr;
+  return p >= arena->base_memory + checkpoint &&
+         p < arena->base_memory + arena->bytes_used;
+}
+
+// Prints usage, high-water mark and allocation count to stdout.
+void Arena_PrintStats(const Arena *arena);
+
+#endif // ARENA_H
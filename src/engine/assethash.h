@@ -0,0 +1,33 @@
+#ifndef ASSETHASH_H
+#define ASSETHASH_H
+
+#include <stdint.h>
+#include <type_traits>
+
+// 64-bit FNV-1a over an asset name. The one name hash used by the asset
+// registries, the asset pack and the packer.
+// constexpr, so a literal name can be hashed at compile time:
+//   constexpr uint64_t kPlayer = AssetHash("player_idle");
+
+#define ASSET_HASH_OFFSET 14695981039346656037ull
+#define ASSET_HASH_PRIME 1099511628211ull
+
+// (Single return statement: constexpr functions are restricted in C++11.)
+constexpr uint64_t AssetHash(const char *name,
+                             uint64_t hash = ASSET_HASH_OFFSET) {
+  return *name ? AssetHash(name + 1,
+                           (hash ^ (uint8_t)*name) * ASSET_HASH_PRIME)
+               : hash;
+}
+
+// An asset name hashed ahead of time. Lookups by ID skip hashing and name
+// compares; the registries refuse (in debug builds, loudly) to hold two
+// names with the same ID, so an ID names exactly one asset.
+typedef uint64_t AssetID;
+
+// Compile-time ID of a literal name: the template argument forces the hash
+// to be a constant expression, so no call site ever hashes at runtime.
+//   Sprite *s = AssetRegistry_FindID(&sprite_registry, ASSET_ID("player"));
+#define ASSET_ID(name) (std::integral_constant<AssetID, AssetHash(name)>::value)
+
+#endif // ASSETHASH_H
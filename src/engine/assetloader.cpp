@@ -0,0 +1,372 @@
+#include "assetloader.h"
+#include "audio.h"
+#include "bkgimagefileloader.h"
+#include "engine.h"
+#include "hotreload.h"
+#include "spritefileloader.h"
+#include <cstring>
+#include <iostream>
+
+// --- Helper: Handles ---
+static inline AssetLoadHandle MakeHandle(int index, uint16_t generation) {
+  return ((uint32_t)generation << 16) | (uint32_t)(index + 1);
+}
+
+static AssetLoadRequest *ResolveHandle(AssetLoader *loader,
+                                       AssetLoadHandle handle) {
+  int index = (int)(handle & 0xFFFF) - 1;
+  if (index < 0 || index >= ASSET_LOADER_MAX_REQUESTS)
+    return nullptr;
+
+  AssetLoadRequest *r = &loader->requests[index];
+  if (r->generation != (uint16_t)(handle >> 16))
+    return nullptr;
+  return r;
+}
+
+// --- Helper: Intrusive FIFO queues (mutex held) ---
+static void QueuePush(AssetLoader *loader, int16_t *head, int16_t *tail,
+                      int index) {
+  loader->requests[index].next = -1;
+  if (*tail >= 0)
+    loader->requests[*tail].next = (int16_t)index;
+  else
+    *head = (int16_t)index;
+  *tail = (int16_t)index;
+}
+
+static int QueuePop(AssetLoader *loader, int16_t *head, int16_t *tail) {
+  int index = *head;
+  if (index < 0)
+    return -1;
+  *head = loader->requests[index].next;
+  if (*head < 0)
+    *tail = -1;
+  return index;
+}
+
+// --- Helper: The actual disk work, on a worker thread ---
+static void *LoadOne(AssetLoader *loader, uint16_t type, const char *path,
+                     uint32_t sample_rate, SoundData *sound) {
+  switch (type) {
+  case ASSET_TYPE_SPRITE:
+    return LoadSpritePBMWithSpans(loader->sprite_arena, path);
+  case ASSET_TYPE_BKGIMAGE:
+    return LoadBkgImagePBM(loader->bkg_arena, path);
+  case ASSET_TYPE_SOUND: {
+    if (sample_rate == 0)
+      return nullptr; // No audio device
+
+    // Same file and compact format the sound cache would use (see audio.h)
+    char full_path[AUDIO_PATH_MAX * 2];
+    snprintf(full_path, sizeof(full_path), "%s/%s", loader->sound_dir, path);
+    if (!SoundData_DecodeFile(full_path, sample_rate, sound)) {
+      std::cerr << "Error: Could not decode sound " << full_path << std::endl;
+      return nullptr;
+    }
+    return sound->samples;
+  }
+  default:
+    return nullptr;
+  }
+}
+
+static void WorkerMain(void *user_data) {
+  AssetLoader *loader = (AssetLoader *)user_data;
+
+  while (true) {
+    Semaphore_Wait(&loader->work_available);
+
+    // 1. Take the most urgent pending request
+    int index = -1;
+    Mutex_Lock(&loader->mutex);
+    if (loader->quitting) {
+      Mutex_Unlock(&loader->mutex);
+      return;
+    }
+    for (int p = 0; p < ASSET_PRIORITY_COUNT && index < 0; p++) {
+      index = QueuePop(loader, &loader->pending_head[p],
+                       &loader->pending_tail[p]);
+    }
+    if (index >= 0)
+      loader->requests[index].status = ASSET_STATUS_LOADING;
+    Mutex_Unlock(&loader->mutex);
+
+    if (index < 0)
+      continue; // Its request was cancelled
+
+    // 2. Load without holding the queue lock. The slot cannot be recycled
+    // while it is LOADING, so reading it here is safe.
+    AssetLoadRequest *r = &loader->requests[index];
+    SoundData sound;
+    memset(&sound, 0, sizeof(sound));
+    void *result =
+        LoadOne(loader, r->type, r->path, loader->sample_rate, &sound);
+
+    // 3. Hand it to the main thread
+    Mutex_Lock(&loader->mutex);
+    r->result = result;
+    r->frame_count = sound.frame_count;
+    r->channels = sound.channels;
+    r->done = true;
+    QueuePush(loader, &loader->completed_head, &loader->completed_tail, index);
+    loader->in_flight--;
+    bool wake_drain = loader->draining && loader->in_flight == 0;
+    if (wake_drain)
+      loader->draining = false;
+    Mutex_Unlock(&loader->mutex);
+
+    // Posted once per drain, so no stale posts pile up between drains
+    if (wake_drain)
+      Semaphore_Post(&loader->work_finished);
+  }
+}
+
+bool AssetLoader_Init(AssetLoader *loader, SpriteArena *sprite_arena,
+                      BkgImageArena *bkg_arena,
+                      SpriteRegistry *sprite_registry,
+                      BkgImageRegistry *bkg_registry, Engine *engine) {
+  memset(loader, 0, sizeof(AssetLoader));
+  for (int p = 0; p < ASSET_PRIORITY_COUNT; p++) {
+    loader->pending_head[p] = -1;
+    loader->pending_tail[p] = -1;
+  }
+  loader->completed_head = -1;
+  loader->completed_tail = -1;
+
+  loader->sprite_arena = sprite_arena;
+  loader->bkg_arena = bkg_arena;
+  loader->sprite_registry = sprite_registry;
+  loader->bkg_registry = bkg_registry;
+  loader->engine = engine;
+  loader->sample_rate = engine ? engine->get_audio_sample_rate() : 0;
+  loader->sound_dir = engine ? engine->get_audio_base_dir() : ".";
+
+  Mutex_Init(&loader->mutex);
+  Semaphore_Init(&loader->work_available, 0);
+  Semaphore_Init(&loader->work_finished, 0);
+
+  // 1. Workers and the main thread now share the arenas
+  Mutex_Init(&loader->sprite_arena_lock);
+  Mutex_Init(&loader->bkg_arena_lock);
+  sprite_arena->lock = &loader->sprite_arena_lock;
+  bkg_arena->lock = &loader->bkg_arena_lock;
+
+  // 2. Workers
+  for (int i = 0; i < ASSET_LOADER_WORKERS; i++) {
+    if (!Thread_Create(&loader->workers[i], WorkerMain, loader))
+      break;
+    loader->worker_count++;
+  }
+
+  if (loader->worker_count == 0) {
+    std::cerr << "Error: AssetLoader could not start any worker thread!"
+              << std::endl;
+    AssetLoader_Shutdown(loader);
+    return false;
+  }
+  return true;
+}
+
+void AssetLoader_Shutdown(AssetLoader *loader) {
+  if (!loader->sprite_arena)
+    return; // Never initialized, or already shut down
+
+  AssetLoader_Drain(loader);
+
+  Mutex_Lock(&loader->mutex);
+  loader->quitting = true;
+  Mutex_Unlock(&loader->mutex);
+
+  for (int i = 0; i < loader->worker_count; i++)
+    Semaphore_Post(&loader->work_available);
+  for (int i = 0; i < loader->worker_count; i++)
+    Thread_Join(&loader->workers[i]);
+  loader->worker_count = 0;
+
+  loader->sprite_arena->lock = nullptr;
+  loader->bkg_arena->lock = nullptr;
+  loader->sprite_arena = nullptr;
+  loader->bkg_arena = nullptr;
+
+  Mutex_Destroy(&loader->sprite_arena_lock);
+  Mutex_Destroy(&loader->bkg_arena_lock);
+  Semaphore_Destroy(&loader->work_finished);
+  Semaphore_Destroy(&loader->work_available);
+  Mutex_Destroy(&loader->mutex);
+}
+
+AssetLoadHandle AssetLoader_Request(AssetLoader *loader, uint16_t type,
+                                    const char *path, int priority,
+                                    AssetLoadCallback callback,
+                                    void *user_data) {
+  if (!loader->sprite_arena || !path)
+    return 0;
+
+  if (strlen(path) >= ASSET_LOADER_PATH_MAX) {
+    std::cerr << "Error: AssetLoader path too long: " << path << std::endl;
+    return 0;
+  }
+  if (type != ASSET_TYPE_SPRITE && type != ASSET_TYPE_BKGIMAGE &&
+      type != ASSET_TYPE_SOUND) {
+    std::cerr << "Error: AssetLoader cannot stream asset type " << type
+              << std::endl;
+    return 0;
+  }
+  if (priority < 0)
+    priority = 0;
+  if (priority >= ASSET_PRIORITY_COUNT)
+    priority = ASSET_PRIORITY_COUNT - 1;
+
+  // 1. Already resident? Then it only needs its callback fired.
+  void *resident = nullptr;
+  if (type == ASSET_TYPE_SPRITE)
+    resident = AssetRegistry_Find(loader->sprite_registry, path);
+  else if (type == ASSET_TYPE_BKGIMAGE)
+    resident = AssetRegistry_Find(loader->bkg_registry, path);
+
+  MutexLock guard(&loader->mutex);
+
+  // 2. Find a slot: never used, or finished and already published
+  int index = -1;
+  for (int n = 0; n < ASSET_LOADER_MAX_REQUESTS; n++) {
+    int i = (loader->next_recycle + n) % ASSET_LOADER_MAX_REQUESTS;
+    uint8_t status = loader->requests[i].status;
+    if (status == ASSET_STATUS_UNKNOWN || status == ASSET_STATUS_LOADED ||
+        status == ASSET_STATUS_FAILED || status == ASSET_STATUS_CANCELLED) {
+      index = i;
+      break;
+    }
+  }
+  if (index < 0) {
+    std::cerr << "Error: AssetLoader queue full! Cannot load " << path
+              << std::endl;
+    return 0;
+  }
+  loader->next_recycle = (index + 1) % ASSET_LOADER_MAX_REQUESTS;
+
+  // 3. Fill it in
+  AssetLoadRequest *r = &loader->requests[index];
+  uint16_t generation = (uint16_t)(r->generation + 1);
+  memset(r, 0, sizeof(AssetLoadRequest));
+  strcpy(r->path, path);
+  r->type = type;
+  r->generation = generation;
+  r->priority = (uint8_t)priority;
+  r->callback = callback;
+  r->user_data = user_data;
+
+  // 4. Queue it
+  if (resident) {
+    r->status = ASSET_STATUS_LOADING;
+    r->result = resident;
+    r->done = true;
+    QueuePush(loader, &loader->completed_head, &loader->completed_tail, index);
+  } else {
+    r->status = ASSET_STATUS_QUEUED;
+    QueuePush(loader, &loader->pending_head[priority],
+              &loader->pending_tail[priority], index);
+    loader->in_flight++;
+    Semaphore_Post(&loader->work_available);
+  }
+
+  return MakeHandle(index, generation);
+}
+
+AssetLoadStatus AssetLoader_Status(AssetLoader *loader,
+                                   AssetLoadHandle handle) {
+  MutexLock guard(&loader->mutex);
+  AssetLoadRequest *r = ResolveHandle(loader, handle);
+  return r ? (AssetLoadStatus)r->status : ASSET_STATUS_UNKNOWN;
+}
+
+int AssetLoader_Pump(AssetLoader *loader, int max_completions) {
+  int processed = 0;
+
+  while (max_completions <= 0 || processed < max_completions) {
+    Mutex_Lock(&loader->mutex);
+    int index =
+        QueuePop(loader, &loader->completed_head, &loader->completed_tail);
+    Mutex_Unlock(&loader->mutex);
+    if (index < 0)
+      break;
+
+    // 1. Publish: from here on the game can look the asset up by path
+    AssetLoadRequest *r = &loader->requests[index];
+    bool success = (r->result != nullptr);
+    void *asset = r->result;
+
+    HotReload *hr = loader->hot_reload;
+    if (success && r->type == ASSET_TYPE_SPRITE) {
+      AssetRegistry_Add(loader->sprite_registry, r->path, (Sprite *)asset);
+      if (hr)
+        HotReload_Track(hr, r->path, HOT_RELOAD_SPRITE, asset);
+    } else if (success && r->type == ASSET_TYPE_BKGIMAGE) {
+      AssetRegistry_Add(loader->bkg_registry, r->path, (BkgImage *)asset);
+      if (hr)
+        HotReload_Track(hr, r->path, HOT_RELOAD_BKGIMAGE, asset);
+    } else if (success && r->type == ASSET_TYPE_SOUND) {
+      // The engine takes ownership of the decoded samples
+      SoundData sound;
+      sound.samples = (int16_t *)asset;
+      sound.frame_count = r->frame_count;
+      sound.channels = r->channels;
+      loader->engine->cache_decoded_sound(r->path, &sound);
+      asset = nullptr;
+      if (hr)
+        HotReload_Track(hr, r->path, HOT_RELOAD_SOUND, nullptr);
+    }
+
+    Mutex_Lock(&loader->mutex);
+    r->status = success ? ASSET_STATUS_LOADED : ASSET_STATUS_FAILED;
+    r->result = nullptr;
+    Mutex_Unlock(&loader->mutex);
+
+    // 2. Notify
+    if (r->callback) {
+      r->callback(MakeHandle(index, r->generation), success, asset,
+                  r->user_data);
+    }
+    processed++;
+  }
+
+  return processed;
+}
+
+void AssetLoader_Drain(AssetLoader *loader) {
+  // 1. Cancel everything no worker has picked up yet
+  int cancelled[ASSET_LOADER_MAX_REQUESTS];
+  int cancelled_count = 0;
+
+  Mutex_Lock(&loader->mutex);
+  for (int p = 0; p < ASSET_PRIORITY_COUNT; p++) {
+    int index;
+    while ((index = QueuePop(loader, &loader->pending_head[p],
+                             &loader->pending_tail[p])) >= 0) {
+      loader->requests[index].status = ASSET_STATUS_CANCELLED;
+      loader->in_flight--;
+      cancelled[cancelled_count++] = index;
+    }
+  }
+  Mutex_Unlock(&loader->mutex);
+
+  for (int i = 0; i < cancelled_count; i++) {
+    AssetLoadRequest *r = &loader->requests[cancelled[i]];
+    if (r->callback) {
+      r->callback(MakeHandle(cancelled[i], r->generation), false, nullptr,
+                  r->user_data);
+    }
+  }
+
+  // 2. Wait for the loads already in progress; the worker that finishes
+  // the last one posts
+  Mutex_Lock(&loader->mutex);
+  bool wait = loader->in_flight > 0;
+  loader->draining = wait;
+  Mutex_Unlock(&loader->mutex);
+  if (wait)
+    Semaphore_Wait(&loader->work_finished);
+
+  // 3. Publish them
+  AssetLoader_Pump(loader, 0);
+}
@@ -0,0 +1,130 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include "assetpack.h" // ASSET_TYPE_*
+#include "bkgimagearena.h"
+#include "bkgimageregistry.h"
+#include "spritearena.h"
+#include "spriteregistry.h"
+#include "thread.h"
+#include <stdint.h>
+
+class Engine; // Forward declaration
+struct HotReload;
+
+// Asynchronous asset streaming.
+// Requests are queued by priority and serviced by I/O worker threads, which
+// read and parse the files and reserve their memory from the (locked) asset
+// arenas. Nothing becomes visible to the game until AssetLoader_Pump runs at
+// a frame boundary on the main thread: it registers the asset in its
+// registry (or the sound cache) under its path and then fires the request's
+// completion callback. A scene change can therefore prefetch everything it
+// needs without stalling a frame on disk access.
+
+#define ASSET_PRIORITY_URGENT 0   // Needed right now, ahead of everything
+#define ASSET_PRIORITY_NORMAL 1   // Needed soon
+#define ASSET_PRIORITY_PREFETCH 2 // Speculative, e.g. the next scene
+#define ASSET_PRIORITY_COUNT 3
+
+#define ASSET_LOADER_MAX_REQUESTS 128
+#define ASSET_LOADER_WORKERS 2
+#define ASSET_LOADER_PATH_MAX 128
+
+typedef enum {
+  ASSET_STATUS_UNKNOWN = 0, // Invalid or recycled handle
+  ASSET_STATUS_QUEUED,
+  ASSET_STATUS_LOADING, // Includes "done, waiting for the next pump"
+  ASSET_STATUS_LOADED,  // Registered and usable
+  ASSET_STATUS_FAILED,
+  ASSET_STATUS_CANCELLED
+} AssetLoadStatus;
+
+// Index + 1 in the low 16 bits, slot generation in the high 16 bits.
+// 0 is never a valid handle.
+typedef uint32_t AssetLoadHandle;
+
+// Runs on the main thread inside AssetLoader_Pump (or AssetLoader_Drain for
+// cancelled requests). 'asset' is the Sprite* / BkgImage*, or nullptr for
+// sounds and failures.
+typedef void (*AssetLoadCallback)(AssetLoadHandle handle, bool success,
+                                  void *asset, void *user_data);
+
+typedef struct {
+  char path[ASSET_LOADER_PATH_MAX];
+  uint16_t type;       // ASSET_TYPE_SPRITE, _BKGIMAGE or _SOUND
+  uint16_t generation; // Bumped every time the slot is reused
+  uint8_t priority;
+  uint8_t status; // AssetLoadStatus
+  bool done;      // Worker finished; waiting for the pump
+  int16_t next;   // Intrusive link in a pending or completed queue
+
+  AssetLoadCallback callback;
+  void *user_data;
+
+  // Filled by the worker
+  void *result;         // Sprite*, BkgImage*, or decoded s16 samples
+  uint64_t frame_count; // Sounds only
+  uint32_t channels;    // Sounds only
+} AssetLoadRequest;
+
+typedef struct AssetLoader {
+  AssetLoadRequest requests[ASSET_LOADER_MAX_REQUESTS];
+
+  // FIFO per priority, plus the completions awaiting the next pump
+  int16_t pending_head[ASSET_PRIORITY_COUNT];
+  int16_t pending_tail[ASSET_PRIORITY_COUNT];
+  int16_t completed_head;
+  int16_t completed_tail;
+  int in_flight;    // Queued or being loaded
+  int next_recycle; // Round-robin cursor for reusing finished slots
+
+  Mutex mutex;
+  Semaphore work_available;
+  Semaphore work_finished; // Posted when a drain's last load finishes
+  Thread workers[ASSET_LOADER_WORKERS];
+  int worker_count;
+  bool quitting;
+  bool draining; // AssetLoader_Drain waits for in_flight to reach 0
+
+  // Destinations
+  SpriteArena *sprite_arena;
+  BkgImageArena *bkg_arena;
+  Mutex sprite_arena_lock;
+  Mutex bkg_arena_lock;
+  SpriteRegistry *sprite_registry;
+  BkgImageRegistry *bkg_registry;
+  Engine *engine;
+  uint32_t sample_rate;  // Sounds are decoded to s16 at this rate
+  const char *sound_dir; // Sound paths are relative to it, like load_sound
+
+  // Optional; published assets are tracked for hot reload
+  struct HotReload *hot_reload;
+} AssetLoader;
+
+// Starts the worker threads and puts both arenas under a lock.
+bool AssetLoader_Init(AssetLoader *loader, SpriteArena *sprite_arena,
+                      BkgImageArena *bkg_arena,
+                      SpriteRegistry *sprite_registry,
+                      BkgImageRegistry *bkg_registry, Engine *engine);
+
+// Cancels what is still queued, joins the workers and unlocks the arenas.
+void AssetLoader_Shutdown(AssetLoader *loader);
+
+// Queues 'path' for loading. Assets already registered complete on the
+// next pump without touching the disk. Returns 0 if the queue is full.
+AssetLoadHandle AssetLoader_Request(AssetLoader *loader, uint16_t type,
+                                    const char *path, int priority,
+                                    AssetLoadCallback callback,
+                                    void *user_data);
+
+AssetLoadStatus AssetLoader_Status(AssetLoader *loader, AssetLoadHandle handle);
+
+// Publishes up to 'max_completions' finished loads (<= 0 for all) and fires
+// their callbacks. Call once per frame on the main thread.
+int AssetLoader_Pump(AssetLoader *loader, int max_completions);
+
+// Cancels queued requests and waits for the ones in progress, then pumps.
+// Required before rewinding an arena the workers may be allocating from.
+void AssetLoader_Drain(AssetLoader *loader);
+
+#endif // ASSETLOADER_H
@@ -0,0 +1,282 @@
+#include "assetpack.h"
+#include "engine.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// --- Helper: Map a whole file copy-on-write ---
+// Pages stay shared with the page cache until written to, so assets can be
+// handed out as non-const pointers without paying for private copies.
+static bool MapFile(AssetPack *pack, const char *filename) {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  if (!mapping) {
+    CloseHandle(file);
+    return false;
+  }
+
+  void *view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  if (!view) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  pack->base = (uint8_t *)view;
+  pack->size = (size_t)size.QuadPart;
+  pack->os_file = file;
+  pack->os_mapping = mapping;
+  return true;
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  void *view = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps the file alive
+  if (view == MAP_FAILED)
+    return false;
+
+  pack->base = (uint8_t *)view;
+  pack->size = (size_t)st.st_size;
+  return true;
+#endif
+}
+
+// --- Helper: Blob validation ---
+// A blob's header fields size the rest of it, so they are checked before
+// they are trusted, in 64-bit arithmetic so nothing wraps on 32-bit builds.
+
+static bool SpriteFits(const Sprite *s, uint64_t size) {
+  if (size < sizeof(Sprite) || s->width <= 0 || s->height <= 0 ||
+      s->width_in_words < (s->width + 31) / 32)
+    return false;
+
+  uint64_t stride = (s->flags & SPRITE_FLAG_INTERLEAVED)
+                        ? (uint64_t)s->width_in_words * 2
+                        : (uint64_t)s->width_in_words;
+  uint64_t bytes = sizeof(Sprite) + stride * 4 * (uint64_t)s->height;
+  if (s->flags & SPRITE_FLAG_SPANS)
+    bytes += Sprite_SpansBytes(s->height);
+  if (bytes > size)
+    return false;
+
+  // The attached mask follows, and has no mask of its own
+  if (!(s->flags & SPRITE_FLAG_MASKED))
+    return true;
+  const Sprite *mask = (const Sprite *)((const uint8_t *)s + bytes);
+  return size - bytes >= sizeof(Sprite) &&
+         !(mask->flags & SPRITE_FLAG_MASKED) && SpriteFits(mask, size - bytes);
+}
+
+static bool BkgImageFits(const BkgImage *b, uint64_t size) {
+  if (size < sizeof(BkgImage) || b->width <= 0 || b->height <= 0 ||
+      b->width_in_words < (b->width + 31) / 32)
+    return false;
+  return sizeof(BkgImage) + (uint64_t)b->width_in_words * 4 * b->height <=
+         size;
+}
+
+static bool FontFits(const BitmapFont *f, uint64_t size) {
+  if (size < sizeof(BitmapFont) || f->glyph_width <= 0 ||
+      f->glyph_width > 32 || f->glyph_height <= 0 || f->glyph_count < 0 ||
+      f->glyph_count > FONT_MAX_GLYPHS)
+    return false;
+  return sizeof(BitmapFont) +
+             (uint64_t)f->glyph_count * f->glyph_height * sizeof(uint32_t) <=
+         size;
+}
+
+static bool BlobFits(const AssetPack *pack, const AssetPackEntry &e) {
+  const void *data = pack->base + e.data_offset;
+  switch (e.type) {
+  case ASSET_TYPE_SPRITE:
+    return SpriteFits((const Sprite *)data, e.data_size);
+  case ASSET_TYPE_BKGIMAGE:
+    return BkgImageFits((const BkgImage *)data, e.data_size);
+  case ASSET_TYPE_FONT:
+    return FontFits((const BitmapFont *)data, e.data_size);
+  default:
+    return true; // Sounds are decoded (and checked) by the audio code
+  }
+}
+
+bool AssetPack_Open(AssetPack *pack, const char *filename) {
+  memset(pack, 0, sizeof(AssetPack));
+
+  if (!MapFile(pack, filename))
+    return false;
+
+  // 1. Header
+  const AssetPackHeader *header = (const AssetPackHeader *)pack->base;
+  if (pack->size < sizeof(AssetPackHeader) ||
+      header->magic != ASSET_PACK_MAGIC ||
+      header->version != ASSET_PACK_VERSION ||
+      header->file_size != pack->size) {
+    std::cerr << "Error: " << filename << " is not a valid asset pack (v"
+              << ASSET_PACK_VERSION << ")" << std::endl;
+    AssetPack_Close(pack);
+    return false;
+  }
+
+  // 2. Index and names must lie inside the file (compared by division and
+  // subtraction, so corrupt counts cannot overflow), and the last name must
+  // end inside the names block
+  size_t max_entries =
+      (pack->size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry);
+  if (header->entry_count > max_entries ||
+      header->names_offset > pack->size ||
+      header->names_size > pack->size - header->names_offset) {
+    std::cerr << "Error: Asset pack " << filename << " is truncated"
+              << std::endl;
+    AssetPack_Close(pack);
+    return false;
+  }
+  if (header->names_size > 0 &&
+      pack->base[header->names_offset + header->names_size - 1] != '\0') {
+    std::cerr << "Error: Asset pack " << filename << " has corrupt names"
+              << std::endl;
+    AssetPack_Close(pack);
+    return false;
+  }
+
+  pack->header = header;
+  pack->entries =
+      (const AssetPackEntry *)(pack->base + sizeof(AssetPackHeader));
+  pack->names = (const char *)(pack->base + header->names_offset);
+
+  // 3. Every blob must lie inside the file too, aligned, and hold the
+  // asset its header describes
+  for (uint32_t i = 0; i < header->entry_count; i++) {
+    const AssetPackEntry &e = pack->entries[i];
+    if (e.data_offset > pack->size ||
+        e.data_size > pack->size - e.data_offset ||
+        e.data_offset % ASSET_PACK_ALIGN != 0 ||
+        e.name_offset >= header->names_size || !BlobFits(pack, e)) {
+      std::cerr << "Error: Asset pack " << filename << " has a corrupt entry"
+                << std::endl;
+      AssetPack_Close(pack);
+      return false;
+    }
+  }
+
+  std::cout << "Mapped asset pack " << filename << " ("
+            << header->entry_count << " assets, " << pack->size / 1024
+            << " KB)" << std::endl;
+  return true;
+}
+
+void AssetPack_Close(AssetPack *pack) {
+  if (pack->base) {
+#ifdef _WIN32
+    UnmapViewOfFile(pack->base);
+    CloseHandle((HANDLE)pack->os_mapping);
+    CloseHandle((HANDLE)pack->os_file);
+#else
+    munmap(pack->base, pack->size);
+#endif
+  }
+  memset(pack, 0, sizeof(AssetPack));
+}
+
+const AssetPackEntry *AssetPack_Find(const AssetPack *pack, const char *name,
+                                     uint16_t type) {
+  if (!pack->header)
+    return nullptr;
+
+  // 1. Lower bound on the hash
+  uint64_t hash = AssetHash(name);
+  uint32_t lo = 0;
+  uint32_t hi = pack->header->entry_count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (pack->entries[mid].name_hash < hash)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  // 2. Entries sharing the hash differ by type or (very rarely) by name
+  for (uint32_t i = lo; i < pack->header->entry_count; i++) {
+    const AssetPackEntry *e = &pack->entries[i];
+    if (e->name_hash != hash)
+      break;
+    if (e->type == type && strcmp(AssetPack_Name(pack, e), name) == 0)
+      return e;
+  }
+  return nullptr;
+}
+
+Sprite *AssetPack_GetSprite(const AssetPack *pack, const char *name) {
+  const AssetPackEntry *e = AssetPack_Find(pack, name, ASSET_TYPE_SPRITE);
+  return e ? (Sprite *)AssetPack_Data(pack, e) : nullptr;
+}
+
+BkgImage *AssetPack_GetBkgImage(const AssetPack *pack, const char *name) {
+  const AssetPackEntry *e = AssetPack_Find(pack, name, ASSET_TYPE_BKGIMAGE);
+  return e ? (BkgImage *)AssetPack_Data(pack, e) : nullptr;
+}
+
+BitmapFont *AssetPack_GetFont(const AssetPack *pack, const char *name) {
+  const AssetPackEntry *e = AssetPack_Find(pack, name, ASSET_TYPE_FONT);
+  return e ? (BitmapFont *)AssetPack_Data(pack, e) : nullptr;
+}
+
+void AssetPack_RegisterAssets(const AssetPack *pack,
+                              SpriteRegistry *sprite_registry,
+                              BkgImageRegistry *bkg_registry) {
+  if (!pack->header)
+    return;
+
+  for (uint32_t i = 0; i < pack->header->entry_count; i++) {
+    const AssetPackEntry *e = &pack->entries[i];
+    const char *name = AssetPack_Name(pack, e);
+
+    if (e->type == ASSET_TYPE_SPRITE) {
+      AssetRegistry_Add(sprite_registry, name,
+                        (Sprite *)AssetPack_Data(pack, e));
+    } else if (e->type == ASSET_TYPE_BKGIMAGE) {
+      AssetRegistry_Add(bkg_registry, name,
+                        (BkgImage *)AssetPack_Data(pack, e));
+    }
+  }
+}
+
+void AssetPack_LoadSounds(const AssetPack *pack, Engine *engine) {
+  if (!pack->header)
+    return;
+
+  for (uint32_t i = 0; i < pack->header->entry_count; i++) {
+    const AssetPackEntry *e = &pack->entries[i];
+    if (e->type != ASSET_TYPE_SOUND)
+      continue;
+    engine->load_sound_memory(AssetPack_Name(pack, e), AssetPack_Data(pack, e),
+                              e->data_size);
+  }
+}
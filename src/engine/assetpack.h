@@ -0,0 +1,101 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include "bkgimage.h"
+#include "bkgimageregistry.h"
+#include "font.h"
+#include "sprite.h"
+#include "spriteregistry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+class Engine; // Forward declaration
+
+// Binary asset pack, baked offline by tools/assetpacker.cpp.
+// Sprites, backgrounds and fonts are stored exactly as the loaders would
+// build them in an arena (they are position independent: the pixels follow
+// the header). At runtime the file is memory-mapped and Sprite* / BkgImage* /
+// BitmapFont* point straight into the mapping: no parsing, no copying, and
+// pages are only faulted in when an asset is first touched.
+//
+// Layout (native byte order, every blob aligned to ASSET_PACK_ALIGN):
+//   AssetPackHeader
+//   AssetPackEntry[entry_count]   sorted by name_hash
+//   names                         null-terminated, referenced by name_offset
+//   blobs
+
+#define ASSET_PACK_MAGIC 0x4B50544Du // "MTPK"
+#define ASSET_PACK_VERSION 2
+#define ASSET_PACK_ALIGN 64
+
+#define ASSET_TYPE_SPRITE 1
+#define ASSET_TYPE_BKGIMAGE 2
+#define ASSET_TYPE_FONT 3
+#define ASSET_TYPE_SOUND 4 // The encoded file (WAV, MP3, FLAC) as-is
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entry_count;
+  uint32_t names_offset;
+  uint32_t names_size;
+  uint32_t _padding;
+  uint64_t file_size;
+} AssetPackHeader;
+
+typedef struct {
+  uint64_t name_hash; // AssetHash(name), same as the asset registries
+  uint16_t type;      // ASSET_TYPE_*
+  uint16_t _padding;
+  uint32_t name_offset; // Into the names block
+  uint32_t data_offset; // From the start of the file
+  uint32_t data_size;
+} AssetPackEntry;
+
+typedef struct {
+  uint8_t *base; // Start of the mapping (copy-on-write)
+  size_t size;
+  const AssetPackHeader *header;
+  const AssetPackEntry *entries;
+  const char *names;
+
+  // Platform handles (file mapping objects on Windows)
+  void *os_file;
+  void *os_mapping;
+} AssetPack;
+
+// Maps 'filename' and validates its header and index.
+// Returns false (and leaves 'pack' empty) on failure.
+bool AssetPack_Open(AssetPack *pack, const char *filename);
+void AssetPack_Close(AssetPack *pack);
+
+// Binary search by name and type. Returns nullptr if absent.
+const AssetPackEntry *AssetPack_Find(const AssetPack *pack, const char *name,
+                                     uint16_t type);
+
+static inline void *AssetPack_Data(const AssetPack *pack,
+                                   const AssetPackEntry *entry) {
+  return pack->base + entry->data_offset;
+}
+
+static inline const char *AssetPack_Name(const AssetPack *pack,
+                                         const AssetPackEntry *entry) {
+  return pack->names + entry->name_offset;
+}
+
+// Typed lookups; nullptr if the pack has no such asset.
+Sprite *AssetPack_GetSprite(const AssetPack *pack, const char *name);
+BkgImage *AssetPack_GetBkgImage(const AssetPack *pack, const char *name);
+BitmapFont *AssetPack_GetFont(const AssetPack *pack, const char *name);
+
+// Registers every sprite and background of the pack in the registries, so
+// AssetRegistry_Find finds them by name.
+void AssetPack_RegisterAssets(const AssetPack *pack,
+                              SpriteRegistry *sprite_registry,
+                              BkgImageRegistry *bkg_registry);
+
+// Decodes every sound of the pack into the engine's sound cache, under its
+// pack name (so play_sound(name) finds it).
+void AssetPack_LoadSounds(const AssetPack *pack, Engine *engine);
+
+#endif // ASSETPACK_H
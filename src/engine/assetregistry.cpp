@@ -0,0 +1,262 @@
+#include "assetregistry.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Never fill past 7/8: keeps probes short and guarantees an empty slot, so
+// every probe loop terminates.
+#define ASSET_TABLE_MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+
+// --- Helper: Home slot of a hash (folds the high half into the index) ---
+static inline uint32_t HomeSlot(const AssetTable *table, uint64_t hash) {
+  return (uint32_t)(hash ^ (hash >> 32)) & (table->capacity - 1);
+}
+
+static inline const char *SlotName(const AssetTable *table,
+                                   const AssetSlot *slot) {
+  return table->names + slot->name_offset;
+}
+
+// Index of the slot holding 'name', or -1.
+static int64_t FindSlot(const AssetTable *table, uint64_t hash,
+                        const char *name) {
+  if (!table->slots)
+    return -1;
+
+  uint32_t mask = table->capacity - 1;
+  uint32_t index = HomeSlot(table, hash);
+  for (uint32_t distance = 0;; distance++) {
+    const AssetSlot *slot = &table->slots[index];
+
+    // An empty slot, or one closer to home than we are, ends the run:
+    // Robin Hood insertion would have placed 'name' before it.
+    if (!slot->asset || slot->distance < distance)
+      return -1;
+    if (slot->hash == hash && strcmp(SlotName(table, slot), name) == 0)
+      return index;
+
+    index = (index + 1) & mask;
+  }
+}
+
+// --- Helper: Squeeze removed names out of the pool ---
+static bool CompactNames(AssetTable *table) {
+  char *old_names = (char *)malloc(table->names_used);
+  if (!old_names)
+    return false;
+  memcpy(old_names, table->names, table->names_used);
+
+  uint32_t used = 0;
+  for (uint32_t i = 0; i < table->capacity; i++) {
+    AssetSlot *slot = &table->slots[i];
+    if (!slot->asset)
+      continue;
+    const char *name = old_names + slot->name_offset;
+    uint32_t length = (uint32_t)strlen(name) + 1;
+    memcpy(table->names + used, name, length);
+    slot->name_offset = used;
+    used += length;
+  }
+
+  free(old_names);
+  table->names_used = used;
+  table->names_garbage = 0;
+  return true;
+}
+
+static bool InternName(AssetTable *table, const char *name,
+                       uint32_t *offset) {
+  uint32_t length = (uint32_t)strlen(name) + 1;
+
+  if (table->names_used + length > table->names_capacity &&
+      table->names_garbage > 0)
+    CompactNames(table);
+
+  if (table->names_used + length > table->names_capacity)
+    return false;
+
+  memcpy(table->names + table->names_used, name, length);
+  *offset = table->names_used;
+  table->names_used += length;
+  return true;
+}
+
+// --- Helper: Backshift deletion ---
+// Pulls the rest of the run back by one, so no tombstone is needed.
+static void RemoveAt(AssetTable *table, uint32_t index) {
+  uint32_t mask = table->capacity - 1;
+  table->names_garbage +=
+      (uint32_t)strlen(SlotName(table, &table->slots[index])) + 1;
+
+  uint32_t next = (index + 1) & mask;
+  while (table->slots[next].asset && table->slots[next].distance > 0) {
+    table->slots[index] = table->slots[next];
+    table->slots[index].distance--;
+    index = next;
+    next = (next + 1) & mask;
+  }
+
+  memset(&table->slots[index], 0, sizeof(AssetSlot));
+  table->count--;
+}
+
+bool AssetTable_Init(AssetTable *table, Arena *arena, const char *label,
+                     uint32_t capacity, uint32_t names_capacity) {
+  memset(table, 0, sizeof(AssetTable));
+  table->label = label;
+
+  uint32_t size = 8;
+  while (size < capacity)
+    size <<= 1;
+
+  table->slots =
+      (AssetSlot *)Arena_Alloc(arena, size * sizeof(AssetSlot), 8);
+  table->names = (char *)Arena_Alloc(arena, names_capacity, 1);
+  if (!table->slots || !table->names) {
+    std::cerr << "Error: No room for asset registry " << label << std::endl;
+    table->slots = nullptr;
+    return false;
+  }
+
+  table->capacity = size;
+  table->names_capacity = names_capacity;
+  AssetTable_Clear(table);
+  return true;
+}
+
+bool AssetTable_Add(AssetTable *table, uint64_t hash, const char *name,
+                    void *asset) {
+  if (!asset || !name || !table->slots)
+    return false;
+
+  // 1. Already registered? Update it in place.
+  int64_t existing = FindSlot(table, hash, name);
+  if (existing >= 0) {
+    table->slots[existing].asset = asset;
+    return true;
+  }
+
+  // A different name with the same hash would make its AssetID ambiguous.
+  // Vanishingly rare with 64 bits, but checked in debug builds.
+#ifndef NDEBUG
+  {
+    uint32_t mask = table->capacity - 1;
+    uint32_t index = HomeSlot(table, hash);
+    for (uint32_t distance = 0;; distance++) {
+      const AssetSlot *slot = &table->slots[index];
+      if (!slot->asset || slot->distance < distance)
+        break;
+      if (slot->hash == hash) {
+        std::cerr << "Error: " << table->label << ": asset names '"
+                  << SlotName(table, slot) << "' and '" << name
+                  << "' have the same AssetID. Rename one." << std::endl;
+        return false;
+      }
+      index = (index + 1) & mask;
+    }
+  }
+#endif
+
+  if (table->count >= ASSET_TABLE_MAX_LOAD(table->capacity)) {
+    std::cerr << "Error: " << table->label << " full! Cannot register "
+              << name << std::endl;
+    return false;
+  }
+
+  // 2. Intern the name
+  AssetSlot entry;
+  entry.hash = hash;
+  entry.asset = asset;
+  entry.distance = 0;
+  if (!InternName(table, name, &entry.name_offset)) {
+    std::cerr << "Error: " << table->label
+              << " name pool full! Cannot register " << name << std::endl;
+    return false;
+  }
+
+  // 3. Robin Hood insert: take the slot of any entry closer to its home,
+  // and carry that one on instead
+  uint32_t mask = table->capacity - 1;
+  uint32_t index = HomeSlot(table, hash);
+  while (true) {
+    AssetSlot *slot = &table->slots[index];
+    if (!slot->asset) {
+      *slot = entry;
+      table->count++;
+      return true;
+    }
+    if (slot->distance < entry.distance) {
+      AssetSlot displaced = *slot;
+      *slot = entry;
+      entry = displaced;
+    }
+    index = (index + 1) & mask;
+    entry.distance++;
+  }
+}
+
+void *AssetTable_Find(const AssetTable *table, uint64_t hash,
+                      const char *name) {
+  int64_t index = FindSlot(table, hash, name);
+  return index >= 0 ? table->slots[index].asset : nullptr;
+}
+
+void *AssetTable_FindID(const AssetTable *table, AssetID id) {
+  if (!table->slots)
+    return nullptr;
+
+  uint32_t mask = table->capacity - 1;
+  uint32_t index = HomeSlot(table, id);
+  for (uint32_t distance = 0;; distance++) {
+    const AssetSlot *slot = &table->slots[index];
+    if (!slot->asset || slot->distance < distance)
+      return nullptr;
+    if (slot->hash == id)
+      return slot->asset; // IDs are unique, see AssetTable_Add
+    index = (index + 1) & mask;
+  }
+}
+
+bool AssetTable_Remove(AssetTable *table, uint64_t hash, const char *name) {
+  int64_t index = FindSlot(table, hash, name);
+  if (index < 0)
+    return false;
+  RemoveAt(table, (uint32_t)index);
+  return true;
+}
+
+int AssetTable_RemoveInRange(AssetTable *table, const void *begin,
+                             const void *end) {
+  int removed = 0;
+  for (uint32_t i = 0; i < table->capacity; i++) {
+    // A backshift moves the next entry into slot i, so check it again
+    while (table->slots[i].asset &&
+           (const uint8_t *)table->slots[i].asset >= (const uint8_t *)begin &&
+           (const uint8_t *)table->slots[i].asset < (const uint8_t *)end) {
+      RemoveAt(table, i);
+      removed++;
+    }
+  }
+  return removed;
+}
+
+int AssetTable_ReplaceAsset(AssetTable *table, const void *old_asset,
+                            void *new_asset) {
+  int replaced = 0;
+  for (uint32_t i = 0; i < table->capacity; i++) {
+    if (table->slots[i].asset == old_asset) {
+      table->slots[i].asset = new_asset;
+      replaced++;
+    }
+  }
+  return replaced;
+}
+
+void AssetTable_Clear(AssetTable *table) {
+  if (!table->slots)
+    return;
+  memset(table->slots, 0, table->capacity * sizeof(AssetSlot));
+  table->count = 0;
+  table->names_used = 0;
+  table->names_garbage = 0;
+}
@@ -0,0 +1,128 @@
+#ifndef ASSETREGISTRY_H
+#define ASSETREGISTRY_H
+
+#include "arena.h"
+#include "assethash.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Name -> asset lookup shared by every asset type.
+// Open addressing with Robin Hood probing over a power-of-two table: an
+// insert displaces entries that sit closer to their home slot, so probe
+// lengths stay short and even, and a lookup can stop as soon as it passes an
+// entry closer to home than itself. Removal shifts the following entries
+// back instead of leaving tombstones.
+//
+// Every name is copied into the registry's own pool (interned), and a match
+// compares the full 64-bit hash and then the name, so two names can never
+// silently replace each other. Names whose hashes collide are refused, which
+// keeps lookups by precomputed AssetID (see ASSET_ID) unambiguous.
+//
+// The slots and the name pool are carved out of an arena once, at init; put
+// the registry below any level checkpoint so it survives rewinds.
+
+typedef struct {
+  uint64_t hash;        // AssetHash(name)
+  void *asset;          // nullptr marks an empty slot
+  uint32_t name_offset; // Into the name pool
+  uint32_t distance;    // Probe distance from the home slot
+} AssetSlot;
+
+typedef struct AssetTable {
+  AssetSlot *slots;
+  uint32_t capacity; // Power of two
+  uint32_t count;
+
+  char *names;
+  uint32_t names_used;
+  uint32_t names_capacity;
+  uint32_t names_garbage; // Bytes of removed names, reclaimed on demand
+
+  const char *label; // Used in error messages
+} AssetTable;
+
+// Type-erased core; use the typed AssetRegistry wrappers below.
+bool AssetTable_Init(AssetTable *table, Arena *arena, const char *label,
+                     uint32_t capacity, uint32_t names_capacity);
+bool AssetTable_Add(AssetTable *table, uint64_t hash, const char *name,
+                    void *asset);
+void *AssetTable_Find(const AssetTable *table, uint64_t hash,
+                      const char *name);
+void *AssetTable_FindID(const AssetTable *table, AssetID id);
+bool AssetTable_Remove(AssetTable *table, uint64_t hash, const char *name);
+int AssetTable_RemoveInRange(AssetTable *table, const void *begin,
+                             const void *end);
+int AssetTable_ReplaceAsset(AssetTable *table, const void *old_asset,
+                            void *new_asset);
+void AssetTable_Clear(AssetTable *table);
+
+// A registry of T (Sprite, BkgImage, ...).
+template <typename T> struct AssetRegistry {
+  AssetTable table;
+};
+
+// 'capacity' is rounded up to a power of two. The pool holds the names,
+// including their terminators. Returns false if the arena is too small.
+template <typename T>
+inline bool AssetRegistry_Init(AssetRegistry<T> *registry, Arena *arena,
+                               const char *label, uint32_t capacity,
+                               uint32_t names_capacity) {
+  return AssetTable_Init(&registry->table, arena, label, capacity,
+                         names_capacity);
+}
+
+// Adds 'name', or points an existing 'name' at 'asset'. Returns false if
+// the registry or its name pool is full.
+template <typename T>
+inline bool AssetRegistry_Add(AssetRegistry<T> *registry, const char *name,
+                              T *asset) {
+  return AssetTable_Add(&registry->table, AssetHash(name), name, asset);
+}
+
+template <typename T>
+inline T *AssetRegistry_Find(const AssetRegistry<T> *registry,
+                             const char *name) {
+  return (T *)AssetTable_Find(&registry->table, AssetHash(name), name);
+}
+
+// Same, with the hash already computed (e.g. at compile time).
+template <typename T>
+inline T *AssetRegistry_FindHashed(const AssetRegistry<T> *registry,
+                                   uint64_t hash, const char *name) {
+  return (T *)AssetTable_Find(&registry->table, hash, name);
+}
+
+// Fast path for IDs computed with ASSET_ID: compares hashes only, so the
+// common case is a single probe of the home slot.
+template <typename T>
+inline T *AssetRegistry_FindID(const AssetRegistry<T> *registry, AssetID id) {
+  return (T *)AssetTable_FindID(&registry->table, id);
+}
+
+template <typename T>
+inline bool AssetRegistry_Remove(AssetRegistry<T> *registry,
+                                 const char *name) {
+  return AssetTable_Remove(&registry->table, AssetHash(name), name);
+}
+
+// Drops every entry whose asset lies in [begin, end), e.g. the part of an
+// arena a rewind is about to free. Returns how many were removed.
+template <typename T>
+inline int AssetRegistry_RemoveInRange(AssetRegistry<T> *registry,
+                                       const void *begin, const void *end) {
+  return AssetTable_RemoveInRange(&registry->table, begin, end);
+}
+
+// Points every entry for 'old_asset' at 'new_asset' (hot reload).
+template <typename T>
+inline int AssetRegistry_ReplaceAsset(AssetRegistry<T> *registry,
+                                      const T *old_asset, T *new_asset) {
+  return AssetTable_ReplaceAsset(&registry->table, old_asset, new_asset);
+}
+
+template <typename T>
+inline void AssetRegistry_Clear(AssetRegistry<T> *registry) {
+  AssetTable_Clear(&registry->table);
+}
+
+#endif // ASSETREGISTRY_H
@@ -0,0 +1,687 @@
+#include "audio.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// --- Helper: Handle <-> slot ---
+static inline VoiceHandle MakeHandle(int slot, uint16_t generation) {
+  return ((VoiceHandle)generation << 16) | (VoiceHandle)(slot + 1);
+}
+
+static inline AudioVoice *FindVoice(const AudioSystem *audio,
+                                    VoiceHandle handle) {
+  int slot = (int)(handle & 0xFFFF) - 1;
+  if (slot < 0 || slot >= AUDIO_MAX_VOICES)
+    return nullptr;
+  AudioVoice *voice = (AudioVoice *)&audio->voices[slot];
+  if (!voice->active || voice->generation != (uint16_t)(handle >> 16))
+    return nullptr;
+  return voice;
+}
+
+// --- Helper: Unlink a voice from the active list ---
+static void UnlinkVoice(AudioSystem *audio, AudioVoice *voice) {
+  if (voice->prev >= 0)
+    audio->voices[voice->prev].next = voice->next;
+  else
+    audio->oldest = voice->next;
+  if (voice->next >= 0)
+    audio->voices[voice->next].prev = voice->prev;
+  else
+    audio->newest = voice->prev;
+}
+
+// --- Helper: Push a command, waiting for room if the ring is full ---
+// Returns false if the command was dropped: the ring is still full once
+// the sync gives up, i.e. the device has stopped pulling.
+static bool PushCommand(AudioSystem *audio, const AudioCommand *command) {
+  // A full ring only happens after hundreds of commands in one frame; the
+  // mixer empties it within a callback
+  if (AudioMixer_Send(&audio->mixer, command))
+    return true;
+  AudioMixer_Sync(&audio->mixer);
+  if (AudioMixer_Send(&audio->mixer, command))
+    return true;
+
+  std::cerr << "Error: Audio mixer not responding, dropped command "
+            << (int)command->type << std::endl;
+  return false;
+}
+
+// --- Helper: Queue a command for the mixer ---
+static bool SendCommand(AudioSystem *audio, uint8_t type, int slot,
+                        float value) {
+  AudioCommand command;
+  memset(&command, 0, sizeof(command));
+  command.type = type;
+  command.voice = (uint16_t)slot;
+  command.generation = audio->voices[slot].generation;
+  command.value = value;
+  if (type == AUDIO_COMMAND_PLAY) {
+    const CachedSound *sound = audio->voices[slot].source;
+    command.samples = sound->data.samples;
+    command.frame_count = sound->data.frame_count;
+    command.channels = (uint8_t)sound->data.channels;
+    command.start_time = audio->frame_time;
+  }
+  return PushCommand(audio, &command);
+}
+
+// --- Helper: Queue a command for one of the mixer's streams ---
+static bool SendStreamCommand(AudioSystem *audio, uint8_t type, int index,
+                              float value, uint32_t ramp_ms) {
+  AudioStream *stream = &audio->streamer.streams[index];
+  AudioCommand command;
+  memset(&command, 0, sizeof(command));
+  command.type = type;
+  command.voice = (uint16_t)index;
+  command.generation = stream->generation;
+  command.value = value;
+  command.frame_count =
+      (uint64_t)ramp_ms * ma_engine_get_sample_rate(&audio->engine) / 1000;
+  if (type == AUDIO_COMMAND_STREAM_PLAY) {
+    command.stream = stream;
+    command.start_time = audio->frame_time;
+  }
+  return PushCommand(audio, &command);
+}
+
+// --- Helper: Give a voice's slot back (the mixer is done with it) ---
+static void ReleaseVoice(AudioSystem *audio, AudioVoice *voice) {
+  UnlinkVoice(audio, voice);
+  voice->next = (int16_t)audio->free_head;
+  audio->free_head = (int)(voice - audio->voices);
+
+  voice->source->playing--;
+  voice->source = nullptr;
+  voice->active = false;
+  voice->generation++; // Outstanding handles go stale
+  audio->active_count--;
+}
+
+// --- Helper: Stop a voice in the mixer and give its slot back ---
+static void StopVoice(AudioSystem *audio, AudioVoice *voice) {
+  // The slot is given back either way. A later PLAY on it replaces the
+  // voice in the mixer; until then the mixer may still read the frames.
+  if (!SendCommand(audio, AUDIO_COMMAND_STOP, (int)(voice - audio->voices),
+                   0))
+    voice->source->stop_lost = true;
+  ReleaseVoice(audio, voice);
+}
+
+// --- Helper: Pick the voice a trigger of 'cached' takes over ---
+static AudioVoice *FindVictim(AudioSystem *audio, const CachedSound *cached) {
+  // 1. At the sound's own limit: its oldest voice, whatever the pool holds
+  if (cached->playing >= cached->max_voices) {
+    for (int i = audio->oldest; i >= 0; i = audio->voices[i].next) {
+      if (audio->voices[i].source == cached)
+        return &audio->voices[i];
+    }
+  }
+
+  // 2. Room in the pool: no one
+  if (audio->free_head >= 0)
+    return nullptr;
+
+  // 3. Pool full: the oldest, or the quietest (oldest among equals)
+  AudioVoice *victim = &audio->voices[audio->oldest];
+  if (audio->steal_mode == AUDIO_STEAL_QUIETEST) {
+    for (int i = victim->next; i >= 0; i = audio->voices[i].next) {
+      if (audio->voices[i].volume < victim->volume)
+        victim = &audio->voices[i];
+    }
+  }
+  return victim;
+}
+
+// --- Helper: Add decoded sound data to the cache ---
+// Takes ownership of 'data' (freed on failure). Returns the new ID or 0.
+static SoundID CacheSound(AudioSystem *audio, const char *name,
+                          const SoundData *data) {
+  // 1. Free pool entry (loading is rare, a scan is fine)
+  CachedSound *sound = nullptr;
+  for (int i = 0; i < AUDIO_MAX_SOUNDS && !sound; i++) {
+    if (!audio->sound_pool[i].data.samples)
+      sound = &audio->sound_pool[i];
+  }
+  if (!sound) {
+    std::cerr << "Error: Sound cache full! Cannot add " << name << std::endl;
+    ma_free(data->samples, NULL);
+    return 0;
+  }
+
+  // 2. Register it under its name
+  if (!AssetRegistry_Add(&audio->sounds, name, sound)) {
+    ma_free(data->samples, NULL);
+    return 0;
+  }
+
+  sound->data = *data;
+  sound->max_voices = AUDIO_DEFAULT_POLYPHONY;
+  sound->playing = 0;
+  sound->stop_lost = false;
+  return AssetHash(name);
+}
+
+// --- Helper: Stop a sound's voices and give its entry back ---
+static void FreeSound(AudioSystem *audio, CachedSound *sound) {
+  // Voices play straight from the cached frames, so stop those first and
+  // let the mixer catch up before the frames go
+  if (sound->playing > 0) {
+    int i = audio->oldest;
+    while (i >= 0) {
+      AudioVoice *voice = &audio->voices[i];
+      i = voice->next;
+      if (voice->source == sound)
+        StopVoice(audio, voice);
+    }
+    AudioMixer_Sync(&audio->mixer);
+  }
+
+  // A voice the mixer never heard stop may still be reading: leak the
+  // frames rather than free them under it
+  if (sound->stop_lost)
+    std::cerr << "Warning: Sound frames kept, the mixer may still play them"
+              << std::endl;
+  else
+    ma_free(sound->data.samples, NULL);
+  sound->data.samples = nullptr;
+  sound->stop_lost = false;
+}
+
+// --- Helper: Shared by the device and the offline init ---
+static bool InitSystem(AudioSystem *audio, const char *base_dir,
+                       bool offline, uint32_t sample_rate) {
+  audio->initialized = false;
+  audio->offline = offline;
+  audio->mixer_ready = false;
+  audio->active_count = 0;
+  audio->oldest = -1;
+  audio->newest = -1;
+  audio->steal_mode = AUDIO_STEAL_OLDEST;
+  audio->frame_time = 0;
+  audio->anchored = false;
+  audio->streamer_ready = false;
+  audio->music = -1;
+  audio->music_volume = 1.0f;
+  memset(audio->voices, 0, sizeof(audio->voices));
+  memset(audio->sound_pool, 0, sizeof(audio->sound_pool));
+  snprintf(audio->base_dir, sizeof(audio->base_dir), "%s",
+           base_dir ? base_dir : ".");
+
+  // 1. Sound registry (sized for AUDIO_MAX_SOUNDS at half load)
+  size_t table_bytes = (size_t)AUDIO_MAX_SOUNDS * 2 * sizeof(AssetSlot);
+  if (!Arena_Init(&audio->arena, "SoundArena",
+                  table_bytes + AUDIO_SOUND_NAMES_SIZE + 64,
+                  ARENA_BACKING_HEAP) ||
+      !AssetRegistry_Init(&audio->sounds, &audio->arena, "SoundRegistry",
+                          AUDIO_MAX_SOUNDS * 2, AUDIO_SOUND_NAMES_SIZE)) {
+    std::cerr << "Failed to create the sound registry." << std::endl;
+    return false;
+  }
+
+  // 2. Every voice starts out free
+  for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+    audio->voices[i].prev = -1;
+    audio->voices[i].next = (int16_t)(i + 1 < AUDIO_MAX_VOICES ? i + 1 : -1);
+  }
+  audio->free_head = 0;
+
+  ma_engine_config config = ma_engine_config_init();
+  config.channels = AUDIO_CHANNELS;
+  config.sampleRate = sample_rate;
+  config.noDevice = offline ? MA_TRUE : MA_FALSE; // Offline: we pull
+
+  if (ma_engine_init(&config, &audio->engine) != MA_SUCCESS) {
+    std::cerr << "Failed to initialize audio engine." << std::endl;
+    return false;
+  }
+
+  // 3. The mixer node does all the playing
+  if (!AudioMixer_Init(&audio->mixer, &audio->engine, offline)) {
+    ma_engine_uninit(&audio->engine);
+    return false;
+  }
+  audio->mixer_ready = true;
+
+  // 4. Music streaming is optional: sounds work without it
+  audio->streamer_ready = AudioStreamer_Init(
+      &audio->streamer, ma_engine_get_sample_rate(&audio->engine), !offline);
+
+  audio->initialized = true;
+  if (offline)
+    std::cout << "Offline audio initialized." << std::endl;
+  else
+    std::cout << "Audio initialized successfully." << std::endl;
+  return true;
+}
+
+bool AudioSystem_Init(AudioSystem *audio, const char *base_dir) {
+  return InitSystem(audio, base_dir, false, AUDIO_SAMPLE_RATE);
+}
+
+bool AudioSystem_InitOffline(AudioSystem *audio, const char *base_dir,
+                             uint32_t sample_rate) {
+  return InitSystem(audio, base_dir, true,
+                    sample_rate ? sample_rate : AUDIO_SAMPLE_RATE);
+}
+
+void AudioSystem_Render(AudioSystem *audio, float *out,
+                        uint32_t frame_count) {
+  if (!audio->initialized || !audio->offline) {
+    memset(out, 0, (size_t)frame_count * AUDIO_CHANNELS * sizeof(float));
+    return;
+  }
+
+  // Streams are topped up first, so they never run dry offline
+  if (audio->streamer_ready)
+    AudioStreamer_Pump(&audio->streamer);
+  ma_engine_read_pcm_frames(&audio->engine, out, frame_count, NULL);
+}
+
+void AudioSystem_Shutdown(AudioSystem *audio) {
+  AudioSystem_Clear(audio);
+  if (audio->initialized) {
+    AudioMixer_Uninit(&audio->mixer);
+    audio->mixer_ready = false;
+    if (audio->streamer_ready)
+      AudioStreamer_Shutdown(&audio->streamer);
+    audio->streamer_ready = false;
+    audio->music = -1;
+    ma_engine_uninit(&audio->engine);
+    audio->initialized = false;
+  }
+  Arena_Release(&audio->arena);
+}
+
+void AudioSystem_Update(AudioSystem *audio, uint64_t time_ms) {
+  if (!audio->initialized)
+    return;
+
+  // 1. Reclaim finished voices. A slot stolen or stopped since its voice
+  // ended has a new generation, so its stale report is ignored.
+  AudioCompletion done;
+  while (AudioMixer_Receive(&audio->mixer, &done)) {
+    // Streams report once the mixer lets go of them (ended or faded out)
+    if (done.voice >= AUDIO_MAX_VOICES) {
+      int index = done.voice - AUDIO_MAX_VOICES;
+      AudioStream *stream = &audio->streamer.streams[index];
+      if (!stream->in_mixer || stream->generation != done.generation)
+        continue;
+      AudioStreamer_Close(&audio->streamer, index);
+      if (audio->music == index)
+        audio->music = -1;
+      continue;
+    }
+
+    AudioVoice *voice = &audio->voices[done.voice];
+    if (voice->active && voice->generation == done.generation)
+      ReleaseVoice(audio, voice);
+  }
+
+  // 2. Map the frame's timestamp onto the mixer clock. The clock only moves
+  // a callback at a time, so frame times are extrapolated from an anchor
+  // and re-anchored when the two drift apart (first frame, stalls).
+  uint64_t clock = AudioMixer_Clock(&audio->mixer);
+  uint64_t rate = ma_engine_get_sample_rate(&audio->engine);
+  uint64_t mapped =
+      audio->anchor_clock + (time_ms - audio->anchor_ms) * rate / 1000;
+  if (!audio->anchored || time_ms < audio->anchor_ms ||
+      mapped + AUDIO_SCHEDULE_LEAD < clock ||
+      mapped > clock + AUDIO_SCHEDULE_LEAD) {
+    audio->anchor_ms = time_ms;
+    audio->anchor_clock = clock;
+    audio->anchored = true;
+    mapped = clock;
+  }
+  audio->frame_time = mapped + AUDIO_SCHEDULE_LEAD;
+}
+
+VoiceHandle AudioSystem_Play(AudioSystem *audio, SoundID id) {
+  if (!audio->initialized)
+    return 0;
+
+  // 1. One probe by ID, no names involved
+  CachedSound *cached = AssetRegistry_FindID(&audio->sounds, id);
+  if (!cached)
+    return 0; // Never loaded (or failed to)
+
+  // 2. Make room (polyphony limit or full pool), then take a free voice
+  AudioVoice *victim = FindVictim(audio, cached);
+  if (victim)
+    StopVoice(audio, victim);
+
+  int slot = audio->free_head;
+  AudioVoice *voice = &audio->voices[slot];
+  audio->free_head = voice->next;
+
+  voice->prev = (int16_t)audio->newest;
+  voice->next = -1;
+  if (audio->newest >= 0)
+    audio->voices[audio->newest].next = (int16_t)slot;
+  else
+    audio->oldest = slot;
+  audio->newest = slot;
+
+  voice->source = cached;
+  voice->volume = 1.0f;
+  voice->active = true;
+  cached->playing++;
+  audio->active_count++;
+
+  // 3. The mixer plays straight from the cached frames (no copy). A PLAY
+  // that never arrives would keep the voice counted forever.
+  if (!SendCommand(audio, AUDIO_COMMAND_PLAY, slot, 0)) {
+    ReleaseVoice(audio, voice);
+    return 0;
+  }
+  return MakeHandle(slot, voice->generation);
+}
+
+void AudioSystem_Stop(AudioSystem *audio, VoiceHandle handle) {
+  AudioVoice *voice = FindVoice(audio, handle);
+  if (!voice)
+    return;
+  StopVoice(audio, voice);
+}
+
+bool AudioSystem_IsPlaying(const AudioSystem *audio, VoiceHandle handle) {
+  return FindVoice(audio, handle) != nullptr;
+}
+
+void AudioSystem_SetVolume(AudioSystem *audio, VoiceHandle handle,
+                           float volume) {
+  AudioVoice *voice = FindVoice(audio, handle);
+  if (!voice)
+    return;
+  voice->volume = volume;
+  SendCommand(audio, AUDIO_COMMAND_VOLUME, (int)(voice - audio->voices),
+              volume);
+}
+
+void AudioSystem_SetPan(AudioSystem *audio, VoiceHandle handle, float pan) {
+  AudioVoice *voice = FindVoice(audio, handle);
+  if (!voice)
+    return;
+  SendCommand(audio, AUDIO_COMMAND_PAN, (int)(voice - audio->voices), pan);
+}
+
+bool AudioSystem_PlayMusic(AudioSystem *audio, const char *name, bool loop,
+                           uint32_t loop_start_ms, uint32_t loop_end_ms,
+                           uint32_t fade_ms) {
+  if (!audio->initialized || !audio->streamer_ready)
+    return false;
+
+  // 1. Claim a stream; the streamer opens the file in the background
+  char path[AUDIO_STREAM_PATH_MAX];
+  snprintf(path, sizeof(path), "%s/%s", audio->base_dir, name);
+  uint64_t rate = ma_engine_get_sample_rate(&audio->engine);
+  uint64_t loop_start = (uint64_t)loop_start_ms * rate / 1000;
+  uint64_t loop_end = (uint64_t)loop_end_ms * rate / 1000;
+  if (loop_end <= loop_start)
+    loop_end = 0;
+  int index =
+      AudioStreamer_Open(&audio->streamer, path, loop, loop_start, loop_end);
+  if (index < 0) {
+    std::cerr << "Error: No free music stream for " << name << std::endl;
+    return false;
+  }
+
+  // 2. Fade the old track out while the new one fades in
+  AudioSystem_StopMusic(audio, fade_ms);
+  audio->streamer.streams[index].in_mixer = true;
+  if (!SendStreamCommand(audio, AUDIO_COMMAND_STREAM_PLAY, index,
+                         audio->music_volume, fade_ms)) {
+    AudioStreamer_Close(&audio->streamer, index); // Never reported back
+    return false;
+  }
+  audio->music = index;
+  return true;
+}
+
+void AudioSystem_StopMusic(AudioSystem *audio, uint32_t fade_ms) {
+  if (audio->music < 0)
+    return;
+  // The mixer reports the stream when the fade ends; Update closes it
+  SendStreamCommand(audio, AUDIO_COMMAND_STREAM_STOP, audio->music, 0,
+                    fade_ms);
+  audio->music = -1;
+}
+
+void AudioSystem_SetMusicVolume(AudioSystem *audio, float volume) {
+  audio->music_volume = volume;
+  if (audio->music >= 0)
+    SendStreamCommand(audio, AUDIO_COMMAND_STREAM_VOLUME, audio->music,
+                      volume, 0);
+}
+
+bool AudioSystem_IsMusicPlaying(const AudioSystem *audio) {
+  return audio->music >= 0;
+}
+
+void AudioSystem_SetVoiceParams(AudioSystem *audio, VoiceParams *params,
+                                int count) {
+  for (int i = 0; i < count; i++) {
+    AudioVoice *voice = FindVoice(audio, params[i].voice);
+    if (!voice) {
+      params[i].voice = 0;
+      continue;
+    }
+
+    // Kept on this side too: quietest-first stealing takes the farthest
+    voice->volume = params[i].volume;
+    AudioCommand command;
+    memset(&command, 0, sizeof(command));
+    command.type = AUDIO_COMMAND_VOLUME_PAN;
+    command.voice = (uint16_t)(voice - audio->voices);
+    command.generation = voice->generation;
+    command.value = params[i].volume;
+    command.pan = params[i].pan;
+    PushCommand(audio, &command);
+  }
+}
+
+void AudioSystem_SetPolyphony(AudioSystem *audio, SoundID id,
+                              int max_voices) {
+  CachedSound *cached = AssetRegistry_FindID(&audio->sounds, id);
+  if (cached)
+    cached->max_voices = max_voices > 0 ? max_voices : 1;
+}
+
+void AudioSystem_SetStealMode(AudioSystem *audio, int mode) {
+  audio->steal_mode = mode;
+}
+
+// --- Helper: Open a decoder producing s16 at 'sample_rate' ---
+// Keeps the source's channel count unless it has more than two.
+static bool OpenDecoder(const char *path, const void *encoded, size_t size,
+                        uint32_t sample_rate, ma_decoder *decoder) {
+  ma_decoder_config config =
+      ma_decoder_config_init(ma_format_s16, 0, sample_rate);
+  for (int attempt = 0; attempt < 2; attempt++) {
+    ma_result result =
+        path ? ma_decoder_init_file(path, &config, decoder)
+             : ma_decoder_init_memory(encoded, size, &config, decoder);
+    if (result != MA_SUCCESS)
+      return false;
+    if (decoder->outputChannels <= AUDIO_CHANNELS)
+      return true;
+
+    // Surround: let miniaudio downmix it
+    ma_decoder_uninit(decoder);
+    config.channels = AUDIO_CHANNELS;
+  }
+  return false;
+}
+
+// --- Helper: Read a decoder to the end into one buffer ---
+static bool DecodeAll(ma_decoder *decoder, SoundData *data) {
+  uint32_t channels = decoder->outputChannels;
+  size_t frame_bytes = channels * sizeof(int16_t);
+
+  // 1. Exact size when the format knows it (one frame over, so the read
+  // that reaches the end is short), else grow from a second
+  ma_uint64 capacity = 0;
+  if (ma_decoder_get_length_in_pcm_frames(decoder, &capacity) != MA_SUCCESS ||
+      capacity == 0)
+    capacity = decoder->outputSampleRate;
+  capacity++;
+
+  int16_t *samples = nullptr;
+  ma_uint64 count = 0;
+  while (true) {
+    int16_t *grown =
+        (int16_t *)ma_realloc(samples, (size_t)capacity * frame_bytes, NULL);
+    if (!grown) {
+      ma_free(samples, NULL);
+      return false;
+    }
+    samples = grown;
+
+    ma_uint64 read = 0;
+    ma_result result = ma_decoder_read_pcm_frames(
+        decoder, samples + count * channels, capacity - count, &read);
+    count += read;
+    if (result != MA_SUCCESS || count < capacity)
+      break;
+    capacity *= 2;
+  }
+
+  if (count == 0) {
+    ma_free(samples, NULL);
+    return false;
+  }
+
+  // 2. Give back the slack
+  int16_t *trimmed =
+      (int16_t *)ma_realloc(samples, (size_t)count * frame_bytes, NULL);
+  data->samples = trimmed ? trimmed : samples;
+  data->frame_count = count;
+  data->channels = channels;
+  return true;
+}
+
+bool SoundData_DecodeFile(const char *path, uint32_t sample_rate,
+                          SoundData *data) {
+  ma_decoder decoder;
+  if (!OpenDecoder(path, nullptr, 0, sample_rate, &decoder))
+    return false;
+  bool ok = DecodeAll(&decoder, data);
+  ma_decoder_uninit(&decoder);
+  return ok;
+}
+
+bool SoundData_DecodeMemory(const void *encoded, size_t size,
+                            uint32_t sample_rate, SoundData *data) {
+  ma_decoder decoder;
+  if (!OpenDecoder(nullptr, encoded, size, sample_rate, &decoder))
+    return false;
+  bool ok = DecodeAll(&decoder, data);
+  ma_decoder_uninit(&decoder);
+  return ok;
+}
+
+// --- Helper: Decode a sound file relative to base_dir ---
+static bool DecodeFile(AudioSystem *audio, const char *name,
+                       SoundData *data) {
+  // Scratch path on the stack, no heap allocation
+  char path[AUDIO_PATH_MAX * 2];
+  snprintf(path, sizeof(path), "%s/%s", audio->base_dir, name);
+
+  if (!SoundData_DecodeFile(path, ma_engine_get_sample_rate(&audio->engine),
+                            data)) {
+    std::cout << "Failed to load sound: " << path << std::endl;
+    return false;
+  }
+  std::cout << "Loaded sound: " << path << std::endl;
+  return true;
+}
+
+SoundID AudioSystem_Load(AudioSystem *audio, const char *name) {
+  if (!audio->initialized)
+    return 0;
+  SoundID id = AssetHash(name);
+  if (AssetRegistry_FindHashed(&audio->sounds, id, name))
+    return id;
+
+  SoundData data;
+  if (!DecodeFile(audio, name, &data))
+    return 0;
+  return CacheSound(audio, name, &data);
+}
+
+SoundID AudioSystem_Reload(AudioSystem *audio, const char *name) {
+  CachedSound *sound = AssetRegistry_Find(&audio->sounds, name);
+  if (!sound)
+    return AudioSystem_Load(audio, name);
+
+  // Decode first: if that fails the old sound stays
+  SoundData data;
+  if (!DecodeFile(audio, name, &data))
+    return 0;
+
+  // Same entry, so the ID and the polyphony limit carry over
+  FreeSound(audio, sound);
+  sound->data = data;
+  return AssetHash(name);
+}
+
+SoundID AudioSystem_LoadMemory(AudioSystem *audio, const char *name,
+                               const void *encoded, size_t size) {
+  if (!audio->initialized)
+    return 0;
+  SoundID id = AssetHash(name);
+  if (AssetRegistry_FindHashed(&audio->sounds, id, name))
+    return id;
+
+  SoundData data;
+  if (!SoundData_DecodeMemory(encoded, size,
+                              ma_engine_get_sample_rate(&audio->engine),
+                              &data)) {
+    std::cout << "Failed to decode sound: " << name << std::endl;
+    return 0;
+  }
+
+  return CacheSound(audio, name, &data);
+}
+
+SoundID AudioSystem_CacheDecoded(AudioSystem *audio, const char *name,
+                                 const SoundData *data) {
+  SoundID id = AssetHash(name);
+  if (!audio->initialized ||
+      AssetRegistry_FindHashed(&audio->sounds, id, name)) {
+    ma_free(data->samples, NULL);
+    return audio->initialized ? id : 0;
+  }
+
+  return CacheSound(audio, name, data);
+}
+
+void AudioSystem_Unload(AudioSystem *audio, const char *name) {
+  CachedSound *sound = AssetRegistry_Find(&audio->sounds, name);
+  if (!sound)
+    return;
+
+  FreeSound(audio, sound);
+  AssetRegistry_Remove(&audio->sounds, name);
+}
+
+void AudioSystem_Clear(AudioSystem *audio) {
+  // 1. Stop all voices, and wait for the mixer to let go of them
+  if (audio->oldest >= 0) {
+    while (audio->oldest >= 0)
+      StopVoice(audio, &audio->voices[audio->oldest]);
+    AudioMixer_Sync(&audio->mixer);
+  }
+
+  // 2. Free cached data
+  for (int i = 0; i < AUDIO_MAX_SOUNDS; i++) {
+    if (audio->sound_pool[i].data.samples)
+      FreeSound(audio, &audio->sound_pool[i]);
+  }
+  AssetRegistry_Clear(&audio->sounds);
+}
+
+uint32_t AudioSystem_SampleRate(const AudioSystem *audio) {
+  return audio->initialized ? ma_engine_get_sample_rate(&audio->engine) : 0;
+}
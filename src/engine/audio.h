@@ -0,0 +1,205 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include "../vendor/miniaudio.h"
+#include "arena.h"
+#include "assetregistry.h"
+#include "audiomixer.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Backend-independent audio: owns the miniaudio engine, the decoded sound
+// cache and a fixed pool of voices. Every Engine backend delegates to one
+// of these (see Engine::audio), so the audio path only exists once.
+//
+// Voices are mixed by the AudioMixer node in the audio callback; this side
+// only does the bookkeeping and talks to it through lock-free rings (see
+// audiomixer.h). Voices move between a free list and an active list (oldest
+// first), so starting, stopping and reclaiming a voice is O(1) and nothing
+// is allocated after init. When the pool, or a sound's polyphony limit, is
+// used up, a playing voice is stolen instead of the trigger being dropped.
+//
+// Sounds are registered once, under their name, in an AssetRegistry like
+// sprites and backgrounds, and are played by SoundID: the name's AssetHash,
+// which is also what ASSET_ID and the asset pack use. Playing by ID is a
+// single hash probe, with no string work.
+//
+// Music is not cached: it is streamed from disk a chunk at a time (see
+// audiostream.h), and a new track can crossfade from the one playing.
+
+#define AUDIO_DEFAULT_POLYPHONY 8 // Voices one sound may use at once
+#define AUDIO_SAMPLE_RATE 22050 // Retro sample rate
+// How far ahead of the mixer a frame's sounds are scheduled: 20 ms, two
+// device periods, so they land on time even if a callback runs early
+#define AUDIO_SCHEDULE_LEAD (AUDIO_SAMPLE_RATE / 50)
+#define AUDIO_PATH_MAX 512
+#define AUDIO_MAX_SOUNDS 256
+#define AUDIO_SOUND_NAMES_SIZE (AUDIO_MAX_SOUNDS * 64)
+
+// AssetHash of the sound's name, e.g. ASSET_ID("./assets/snd/boing.wav").
+// 0 means no sound.
+typedef AssetID SoundID;
+
+// Identifies one playback: slot index in the low 16 bits, the slot's
+// generation in the high 16. A handle goes stale once its voice ends, so it
+// can be kept and checked safely. 0 is never a valid handle.
+typedef uint32_t VoiceHandle;
+
+// Sounds are kept compact: 16-bit samples in the file's own channel count
+// (mono stays mono), resampled to the mixer rate once at load. The mixer
+// converts and upmixes as it plays (see audiomixer.h), so a mono effect
+// takes a quarter of the memory of stereo float frames.
+typedef struct SoundData {
+  int16_t *samples; // Interleaved, allocated with ma_malloc
+  uint64_t frame_count;
+  uint32_t channels; // 1 or 2
+} SoundData;
+
+// Decodes a whole file (or an encoded file in memory) to SoundData at
+// 'sample_rate'. Touches no AudioSystem state, so it is safe on a worker
+// thread. Free the result with ma_free(data->samples, NULL).
+bool SoundData_DecodeFile(const char *path, uint32_t sample_rate,
+                          SoundData *data);
+bool SoundData_DecodeMemory(const void *encoded, size_t size,
+                            uint32_t sample_rate, SoundData *data);
+
+// data.samples is nullptr while the pool entry is unused
+typedef struct {
+  SoundData data;
+  int max_voices; // Polyphony limit, AUDIO_DEFAULT_POLYPHONY unless set
+  int playing;    // Voices currently playing this sound
+  bool stop_lost; // A voice's STOP never reached the mixer (see FreeSound)
+} CachedSound;
+
+// Which voice a trigger takes over when the pool is full
+#define AUDIO_STEAL_OLDEST 0
+#define AUDIO_STEAL_QUIETEST 1 // Lowest volume, oldest among equals
+
+// Game-side view of a mixer voice
+typedef struct {
+  CachedSound *source;
+  float volume;
+  int16_t prev, next; // Active list links (free list uses 'next'), -1 ends
+  uint16_t generation;
+  bool active;
+} AudioVoice;
+
+typedef struct AudioSystem {
+  ma_engine engine;
+  bool initialized;
+  bool offline; // No device, see AudioSystem_InitOffline
+
+  char base_dir[AUDIO_PATH_MAX]; // Relative file names are resolved here
+
+  // Sound cache: a fixed pool of entries, found by name or SoundID
+  Arena arena; // Registry slots and names
+  AssetRegistry<CachedSound> sounds;
+  CachedSound sound_pool[AUDIO_MAX_SOUNDS];
+
+  AudioMixer mixer;
+  bool mixer_ready;
+
+  AudioVoice voices[AUDIO_MAX_VOICES];
+  int free_head; // Free list, -1 when every voice is playing
+  int oldest;       // Active list, oldest trigger first
+  int newest;
+  int active_count;
+  int steal_mode; // AUDIO_STEAL_*
+
+  // Mixer clock value this frame's sounds start at, and the pairing of
+  // game time and mixer clock it is extrapolated from
+  uint64_t frame_time;
+  uint64_t anchor_ms;
+  uint64_t anchor_clock;
+  bool anchored;
+
+  // Music
+  AudioStreamer streamer;
+  bool streamer_ready;
+  int music;          // Stream slot of the current track, -1 for none
+  float music_volume;
+} AudioSystem;
+
+// Opens the default playback device. Returns false (and leaves audio
+// silent, but every call safe) if there is none.
+bool AudioSystem_Init(AudioSystem *audio, const char *base_dir);
+void AudioSystem_Shutdown(AudioSystem *audio);
+
+// Offline render: no device and no audio or streamer thread. The caller
+// pulls the mix with AudioSystem_Render, e.g. one game tick's worth of
+// frames per tick from a virtual clock, so the output depends only on what
+// the game did and when (headless runs, regression tests, benchmarks).
+// 'sample_rate' 0 means AUDIO_SAMPLE_RATE.
+bool AudioSystem_InitOffline(AudioSystem *audio, const char *base_dir,
+                             uint32_t sample_rate);
+// Mixes the next 'frame_count' frames (AUDIO_CHANNELS interleaved floats)
+// into 'out' and advances the mixer clock. Silence unless offline.
+void AudioSystem_Render(AudioSystem *audio, float *out, uint32_t frame_count);
+
+// Reclaims the voices the mixer reports finished and maps the frame's
+// timestamp (in ms, any epoch) onto the mixer clock. Call once per frame,
+// before the frame triggers sounds.
+void AudioSystem_Update(AudioSystem *audio, uint64_t time_ms);
+
+// Starts a loaded sound. If it already plays on its polyphony limit, its
+// oldest voice restarts; if the pool is full, a voice is stolen per the
+// steal mode. Returns 0 only if no sound has that ID. The sound starts at
+// the current frame's time, see AudioSystem_Update.
+VoiceHandle AudioSystem_Play(AudioSystem *audio, SoundID id);
+void AudioSystem_Stop(AudioSystem *audio, VoiceHandle handle);
+// True until the update after the voice ended
+bool AudioSystem_IsPlaying(const AudioSystem *audio, VoiceHandle handle);
+void AudioSystem_SetVolume(AudioSystem *audio, VoiceHandle handle,
+                           float volume);
+// -1 (left) .. 1 (right)
+void AudioSystem_SetPan(AudioSystem *audio, VoiceHandle handle, float pan);
+
+// Volume and pan for one voice, see AudioSystem_SetVoiceParams
+typedef struct VoiceParams {
+  VoiceHandle voice;
+  float volume;
+  float pan;
+} VoiceParams;
+
+// Sets the volume and pan of many voices in one call (one mixer command
+// each), e.g. positional audio for every emitter in a tick. Entries whose
+// voice has ended get 'voice' set to 0, so the caller can drop them.
+void AudioSystem_SetVoiceParams(AudioSystem *audio, VoiceParams *params,
+                                int count);
+
+// Streams 'name' as music, starting at the current frame's time and
+// crossfading from the current track over 'fade_ms' (0 cuts straight to
+// it). A looping track jumps from 'loop_end_ms' (0: the end of the file)
+// back to 'loop_start_ms'. Returns false without audio, or if every stream
+// is still busy fading out; a file that cannot be opened just ends.
+bool AudioSystem_PlayMusic(AudioSystem *audio, const char *name, bool loop,
+                           uint32_t loop_start_ms, uint32_t loop_end_ms,
+                           uint32_t fade_ms);
+void AudioSystem_StopMusic(AudioSystem *audio, uint32_t fade_ms);
+void AudioSystem_SetMusicVolume(AudioSystem *audio, float volume);
+// True until the update after the track ended (never, while it loops)
+bool AudioSystem_IsMusicPlaying(const AudioSystem *audio);
+
+// Voice limits
+void AudioSystem_SetPolyphony(AudioSystem *audio, SoundID id,
+                              int max_voices);
+void AudioSystem_SetStealMode(AudioSystem *audio, int mode);
+
+// Sound cache. Each returns the sound's ID (also when it was already
+// loaded), or 0 on failure. Loading is the only step that touches names.
+SoundID AudioSystem_Load(AudioSystem *audio, const char *name);
+SoundID AudioSystem_LoadMemory(AudioSystem *audio, const char *name,
+                               const void *encoded, size_t size);
+// Takes ownership of 'data' (see SoundData_DecodeFile)
+SoundID AudioSystem_CacheDecoded(AudioSystem *audio, const char *name,
+                                 const SoundData *data);
+// Reads 'name' again in place (hot reload): its ID and settings are kept,
+// and its voices stop.
+SoundID AudioSystem_Reload(AudioSystem *audio, const char *name);
+void AudioSystem_Unload(AudioSystem *audio, const char *name);
+void AudioSystem_Clear(AudioSystem *audio);
+
+// Device rate sounds are decoded to, or 0 without audio
+uint32_t AudioSystem_SampleRate(const AudioSystem *audio);
+
+#endif // AUDIO_H
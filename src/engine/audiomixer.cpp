@@ -0,0 +1,410 @@
+#include "audiomixer.h"
+#include "thread.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Sync gives up on a device that has stopped pulling for this long
+#define AUDIO_SYNC_TIMEOUT_MS 250
+
+// Maps s16 to -1..1; folded into the voice gains
+#define S16_SCALE (1.0f / 32768.0f)
+
+// --- Helper: Balance pan, like miniaudio's default pan mode ---
+static void UpdateGains(MixVoice *voice) {
+  float gain = voice->volume * S16_SCALE;
+  voice->gain_left = gain * (voice->pan > 0 ? 1.0f - voice->pan : 1);
+  voice->gain_right = gain * (voice->pan < 0 ? 1.0f + voice->pan : 1);
+}
+
+// --- Helper: Take a voice off the packed playing list ---
+static void RemovePlaying(AudioMixer *mixer, MixVoice *voice) {
+  int index = voice->playing_index;
+  uint16_t moved = mixer->playing[--mixer->playing_count];
+  mixer->playing[index] = moved;
+  mixer->voices[moved].playing_index = (int16_t)index;
+  voice->playing_index = -1;
+}
+
+// --- Helper: Glide a stream's gain to 'target' over 'frames' ---
+static void StartRamp(MixStream *stream, float target, uint64_t frames) {
+  stream->target = target;
+  if (frames == 0) {
+    stream->volume = target;
+    stream->ramp_frames = 0;
+    return;
+  }
+  if (frames > UINT32_MAX)
+    frames = UINT32_MAX;
+  stream->ramp_frames = (uint32_t)frames;
+  stream->step = (target - stream->volume) / (float)frames;
+}
+
+// --- Helper: Apply one stream command from the game thread ---
+static void ApplyStreamCommand(AudioMixer *mixer,
+                               const AudioCommand *command) {
+  if (command->voice >= AUDIO_MAX_STREAMS)
+    return;
+  MixStream *stream = &mixer->streams[command->voice];
+
+  if (command->type == AUDIO_COMMAND_STREAM_PLAY) {
+    stream->source = command->stream;
+    stream->start_time = command->start_time;
+    stream->started = false;
+    stream->stopping = false;
+    stream->generation = command->generation;
+    stream->volume = command->frame_count ? 0.0f : command->value;
+    StartRamp(stream, command->value, command->frame_count);
+    return;
+  }
+
+  // A late command for a stream already let go of is dropped
+  if (!stream->source || stream->generation != command->generation ||
+      stream->stopping)
+    return;
+  if (command->type == AUDIO_COMMAND_STREAM_STOP) {
+    stream->stopping = true;
+    StartRamp(stream, 0.0f, command->frame_count);
+  } else {
+    StartRamp(stream, command->value, command->frame_count);
+  }
+}
+
+// --- Helper: Apply one command from the game thread ---
+static void ApplyCommand(AudioMixer *mixer, const AudioCommand *command) {
+  if (command->type >= AUDIO_COMMAND_STREAM_PLAY &&
+      command->type <= AUDIO_COMMAND_STREAM_VOLUME) {
+    ApplyStreamCommand(mixer, command);
+    return;
+  }
+  if (command->voice >= AUDIO_MAX_VOICES)
+    return;
+  MixVoice *voice = &mixer->voices[command->voice];
+
+  switch (command->type) {
+  case AUDIO_COMMAND_PLAY:
+    if (voice->playing_index < 0) {
+      voice->playing_index = (int16_t)mixer->playing_count;
+      mixer->playing[mixer->playing_count++] = command->voice;
+    }
+    voice->samples = command->samples;
+    voice->frame_count = command->frame_count;
+    voice->channels = command->channels;
+    voice->cursor = 0;
+    voice->start_time = command->start_time;
+    voice->volume = 1.0f;
+    voice->pan = 0.0f;
+    voice->generation = command->generation;
+    UpdateGains(voice);
+    break;
+
+  case AUDIO_COMMAND_STOP:
+    if (voice->playing_index >= 0)
+      RemovePlaying(mixer, voice);
+    break;
+
+  case AUDIO_COMMAND_VOLUME:
+  case AUDIO_COMMAND_PAN:
+  case AUDIO_COMMAND_VOLUME_PAN:
+    // A late command for a slot that has been retriggered is dropped
+    if (voice->playing_index < 0 || voice->generation != command->generation)
+      break;
+    if (command->type == AUDIO_COMMAND_PAN)
+      voice->pan = command->value;
+    else
+      voice->volume = command->value;
+    if (command->type == AUDIO_COMMAND_VOLUME_PAN)
+      voice->pan = command->pan;
+    UpdateGains(voice);
+    break;
+  }
+}
+
+// --- Helper: Apply everything the game thread has sent ---
+static void ApplyCommands(AudioMixer *mixer) {
+  AudioCommand command;
+  while (SPSCRing_Pop(&mixer->commands, &command))
+    ApplyCommand(mixer, &command);
+}
+
+#ifdef __SSE2__
+// --- Helper: 8 s16 samples -> two vectors of 4 floats ---
+static inline void LoadS16x8(const int16_t *in, __m128 *lo, __m128 *hi) {
+  __m128i s = _mm_loadu_si128((const __m128i *)in);
+  // Each sample into the top half of a 32-bit lane, then shifted back down
+  // with its sign
+  *lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+  *hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+}
+
+static inline void Accumulate(float *out, __m128 value) {
+  _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), value));
+}
+#endif
+
+// --- Helper: Mono s16, upmixed into both output channels ---
+static void MixMono(float *out, const int16_t *in, uint32_t count,
+                    float gain_left, float gain_right) {
+  uint32_t i = 0;
+#ifdef __SSE2__
+  __m128 left = _mm_set1_ps(gain_left);
+  __m128 right = _mm_set1_ps(gain_right);
+  for (; i + 8 <= count; i += 8) {
+    __m128 lo, hi;
+    LoadS16x8(in + i, &lo, &hi);
+    float *o = out + i * 2;
+
+    // m0 m1 m2 m3 -> L0 R0 L1 R1, L2 R2 L3 R3
+    __m128 l = _mm_mul_ps(lo, left), r = _mm_mul_ps(lo, right);
+    Accumulate(o, _mm_unpacklo_ps(l, r));
+    Accumulate(o + 4, _mm_unpackhi_ps(l, r));
+    l = _mm_mul_ps(hi, left);
+    r = _mm_mul_ps(hi, right);
+    Accumulate(o + 8, _mm_unpacklo_ps(l, r));
+    Accumulate(o + 12, _mm_unpackhi_ps(l, r));
+  }
+#endif
+  for (; i < count; i++) {
+    float sample = in[i];
+    out[i * 2] += sample * gain_left;
+    out[i * 2 + 1] += sample * gain_right;
+  }
+}
+
+// --- Helper: Stereo s16 ---
+static void MixStereo(float *out, const int16_t *in, uint32_t count,
+                      float gain_left, float gain_right) {
+  uint32_t i = 0;
+#ifdef __SSE2__
+  __m128 gains = _mm_setr_ps(gain_left, gain_right, gain_left, gain_right);
+  for (; i + 4 <= count; i += 4) {
+    __m128 lo, hi; // L0 R0 L1 R1, L2 R2 L3 R3
+    LoadS16x8(in + i * 2, &lo, &hi);
+    Accumulate(out + i * 2, _mm_mul_ps(lo, gains));
+    Accumulate(out + i * 2 + 4, _mm_mul_ps(hi, gains));
+  }
+#endif
+  for (; i < count; i++) {
+    out[i * 2] += in[i * 2] * gain_left;
+    out[i * 2 + 1] += in[i * 2 + 1] * gain_right;
+  }
+}
+
+// --- Helper: Stereo s16 under a stream's gain ramp ---
+static void MixRamped(float *out, const int16_t *in, uint32_t count,
+                      MixStream *stream) {
+  // 1. Frame by frame while the gain moves
+  uint32_t i = 0;
+  for (; i < count && stream->ramp_frames > 0; i++) {
+    float gain = stream->volume * S16_SCALE;
+    out[i * 2] += in[i * 2] * gain;
+    out[i * 2 + 1] += in[i * 2 + 1] * gain;
+    stream->volume += stream->step;
+    if (--stream->ramp_frames == 0)
+      stream->volume = stream->target;
+  }
+
+  // 2. Then at a steady gain
+  if (i < count) {
+    float gain = stream->volume * S16_SCALE;
+    MixStereo(out + i * 2, in + i * 2, count - i, gain, gain);
+  }
+}
+
+// --- Helper: Mix one block of a stream; false once it is done with ---
+static bool MixStreamBlock(MixStream *stream, float *out, uint32_t frame_count,
+                           uint64_t block_start) {
+  AudioStream *source = stream->source;
+
+  // 1. Stopped outright (or faded out last block)
+  if (stream->stopping && stream->ramp_frames == 0)
+    return false;
+
+  // 2. Not due yet, or still waiting for its first chunk
+  uint32_t offset = 0;
+  if (stream->start_time > block_start) {
+    if (stream->start_time >= block_start + frame_count)
+      return true;
+    offset = (uint32_t)(stream->start_time - block_start);
+  }
+  // 'ended' first: the streamer publishes its last frames before it
+  bool ended = AudioStream_Ended(source);
+  uint32_t available = AudioStream_Available(source);
+  if (!stream->started) {
+    if (available < AUDIO_STREAM_CHUNK && !ended)
+      return true;
+    stream->started = true;
+  }
+
+  // 3. What the ring holds, in up to two runs around its wrap. If it runs
+  // dry the rest of the block stays silent.
+  uint32_t count = frame_count - offset;
+  if (count > available)
+    count = available;
+  out += (size_t)offset * AUDIO_CHANNELS;
+  uint32_t head = source->head;
+  for (uint32_t mixed = 0; mixed < count;) {
+    uint32_t at = (head + mixed) & (AUDIO_STREAM_FRAMES - 1);
+    uint32_t run = count - mixed;
+    if (run > AUDIO_STREAM_FRAMES - at)
+      run = AUDIO_STREAM_FRAMES - at;
+    MixRamped(out + (size_t)mixed * AUDIO_CHANNELS,
+              source->frames + (size_t)at * AUDIO_CHANNELS, run, stream);
+    mixed += run;
+  }
+  __atomic_store_n(&source->head, head + count, __ATOMIC_RELEASE);
+
+  // 4. Played to its end, or faded out
+  if (ended && count == available)
+    return false;
+  return !(stream->stopping && stream->ramp_frames == 0);
+}
+
+// --- Helper: miniaudio node callback (no inputs, one output bus) ---
+static void MixerProcess(ma_node *node, const float **frames_in,
+                         ma_uint32 *frame_count_in, float **frames_out,
+                         ma_uint32 *frame_count_out) {
+  (void)frames_in;
+  (void)frame_count_in;
+  AudioMixer_Mix((AudioMixer *)node, frames_out[0], *frame_count_out);
+}
+
+static ma_node_vtable mixer_vtable = {MixerProcess, NULL, 0, 1, 0};
+
+bool AudioMixer_Init(AudioMixer *mixer, ma_engine *engine, bool offline) {
+  // 1. Idle state, set up before the audio thread can see the node
+  SPSCRing_Init(&mixer->commands);
+  SPSCRing_Init(&mixer->completions);
+  memset(mixer->voices, 0, sizeof(mixer->voices));
+  for (int i = 0; i < AUDIO_MAX_VOICES; i++)
+    mixer->voices[i].playing_index = -1;
+  mixer->playing_count = 0;
+  memset(mixer->streams, 0, sizeof(mixer->streams));
+  mixer->clock = 0;
+  mixer->offline = offline;
+
+  // 2. One node, straight into the endpoint
+  ma_uint32 channels = AUDIO_CHANNELS;
+  ma_node_config config = ma_node_config_init();
+  config.vtable = &mixer_vtable;
+  config.pOutputChannels = &channels;
+  if (ma_node_init(ma_engine_get_node_graph(engine), &config, NULL,
+                   &mixer->base) != MA_SUCCESS) {
+    std::cerr << "Failed to create the audio mixer node." << std::endl;
+    return false;
+  }
+
+  if (ma_node_attach_output_bus(&mixer->base, 0, ma_engine_get_endpoint(engine),
+                                0) != MA_SUCCESS) {
+    std::cerr << "Failed to attach the audio mixer node." << std::endl;
+    ma_node_uninit(&mixer->base, NULL);
+    return false;
+  }
+  return true;
+}
+
+void AudioMixer_Uninit(AudioMixer *mixer) {
+  // Detaches first, waiting for a callback in progress to finish
+  ma_node_uninit(&mixer->base, NULL);
+}
+
+bool AudioMixer_Send(AudioMixer *mixer, const AudioCommand *command) {
+  return SPSCRing_Push(&mixer->commands, command);
+}
+
+bool AudioMixer_Receive(AudioMixer *mixer, AudioCompletion *completion) {
+  return SPSCRing_Pop(&mixer->completions, completion);
+}
+
+void AudioMixer_Sync(AudioMixer *mixer) {
+  // Offline there is no other side to wait for
+  if (mixer->offline) {
+    ApplyCommands(mixer);
+    return;
+  }
+
+  // Commands are popped before any voice is mixed, so an empty ring means
+  // no voice reads what the game side stopped
+  uint64_t clock = AudioMixer_Clock(mixer);
+  int waited_ms = 0;
+  while (!SPSCRing_IsEmpty(&mixer->commands)) {
+    Thread_Sleep(1);
+    if (AudioMixer_Clock(mixer) != clock) {
+      clock = AudioMixer_Clock(mixer);
+      waited_ms = 0;
+    } else if (++waited_ms >= AUDIO_SYNC_TIMEOUT_MS) {
+      return; // Device stopped: the commands apply before the next mix
+    }
+  }
+}
+
+void AudioMixer_Mix(AudioMixer *mixer, float *out, uint32_t frame_count) {
+  // 1. Commands first, so nothing stopped is read again
+  ApplyCommands(mixer);
+
+  // 2. Mix every active voice
+  memset(out, 0, (size_t)frame_count * AUDIO_CHANNELS * sizeof(float));
+  uint64_t block_start = mixer->clock;
+  uint64_t block_end = block_start + frame_count;
+
+  int i = 0;
+  while (i < mixer->playing_count) {
+    MixVoice *voice = &mixer->voices[mixer->playing[i]];
+
+    // Scheduled later in this block, or in a later one
+    uint32_t offset = 0;
+    if (voice->start_time > block_start) {
+      if (voice->start_time >= block_end) {
+        i++;
+        continue;
+      }
+      offset = (uint32_t)(voice->start_time - block_start);
+    }
+
+    uint64_t remaining = voice->frame_count - voice->cursor;
+    uint32_t count = frame_count - offset;
+    if (remaining < count)
+      count = (uint32_t)remaining;
+
+    float *dst = out + (size_t)offset * AUDIO_CHANNELS;
+    const int16_t *src = voice->samples + voice->cursor * voice->channels;
+    if (voice->channels == 1)
+      MixMono(dst, src, count, voice->gain_left, voice->gain_right);
+    else
+      MixStereo(dst, src, count, voice->gain_left, voice->gain_right);
+    voice->cursor += count;
+
+    if (voice->cursor < voice->frame_count) {
+      i++;
+      continue;
+    }
+
+    // 3. Finished: report it (the slot is retaken in place, so the voice
+    // now at 'i' is visited next). A full completion ring only delays the
+    // game side's reclaim until it stops or steals the voice.
+    AudioCompletion done;
+    done.voice = mixer->playing[i];
+    done.generation = voice->generation;
+    SPSCRing_Push(&mixer->completions, &done);
+    RemovePlaying(mixer, voice);
+  }
+
+  // 4. Streams, reported like voices when they are let go of
+  for (int s = 0; s < AUDIO_MAX_STREAMS; s++) {
+    MixStream *stream = &mixer->streams[s];
+    if (!stream->source ||
+        MixStreamBlock(stream, out, frame_count, block_start))
+      continue;
+
+    AudioCompletion done;
+    done.voice = (uint16_t)(AUDIO_MAX_VOICES + s);
+    done.generation = stream->generation;
+    SPSCRing_Push(&mixer->completions, &done);
+    stream->source = nullptr;
+  }
+
+  __atomic_store_n(&mixer->clock, block_end, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,142 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include "../vendor/miniaudio.h"
+#include "audiostream.h"
+#include "spscring.h"
+#include <stdint.h>
+
+// The mixer: a single custom miniaudio node that mixes every voice itself,
+// inside the audio callback. The game thread never touches a playing voice.
+// It sends play / stop / volume / pan commands over one lock-free ring and
+// hears about voices that finished over another (see spscring.h), so
+// neither thread ever waits for the other.
+//
+// Time is the mixer's clock: frames mixed since init. A play command names
+// the clock value its first frame lands on, so a sound starts on the exact
+// sample its game frame maps to instead of at the next callback boundary.
+//
+// Voices read 16-bit mono or stereo samples and are converted to float,
+// scaled and upmixed while mixing, four frames at a time with SSE2 where
+// the target has it.
+//
+// Streams (see audiostream.h) are mixed alongside the voices, straight out
+// of their rings, each with a gain that can ramp over a number of frames
+// for fades and crossfades. A stream that runs dry before its end plays
+// silence until the streamer catches up.
+
+// Overridable at build time, e.g. -DAUDIO_MAX_VOICES=512 for the mixer
+// benchmark. The completion ring should hold a report from every voice.
+#ifndef AUDIO_MAX_VOICES
+#define AUDIO_MAX_VOICES 64
+#endif
+#ifndef AUDIO_COMPLETION_RING_SIZE
+#define AUDIO_COMPLETION_RING_SIZE 256 // Power of two
+#endif
+#define AUDIO_CHANNELS 2
+#define AUDIO_COMMAND_RING_SIZE 1024 // Power of two
+
+#define AUDIO_COMMAND_PLAY 0
+#define AUDIO_COMMAND_STOP 1
+#define AUDIO_COMMAND_VOLUME 2
+#define AUDIO_COMMAND_PAN 3
+#define AUDIO_COMMAND_VOLUME_PAN 7 // Both at once (positional audio)
+#define AUDIO_COMMAND_STREAM_PLAY 4   // Ramps from 0 over frame_count
+#define AUDIO_COMMAND_STREAM_STOP 5   // Ramps to 0 over frame_count
+#define AUDIO_COMMAND_STREAM_VOLUME 6 // Ramps to value over frame_count
+
+typedef struct {
+  uint8_t type;           // AUDIO_COMMAND_*
+  uint8_t channels;       // PLAY: 1 or 2
+  uint16_t voice;         // Slot, < AUDIO_MAX_VOICES (streams: stream slot)
+  uint16_t generation;    // Trigger the command belongs to
+  float value;            // VOLUME: gain. PAN: -1 (left) .. 1 (right)
+  float pan;              // VOLUME_PAN: pan, with the gain in 'value'
+  const int16_t *samples; // PLAY: owned by the game side
+  AudioStream *stream;    // STREAM_PLAY
+  uint64_t frame_count;   // PLAY: length. STREAM_*: ramp length
+  uint64_t start_time;    // PLAY, STREAM_PLAY: clock value of the first frame
+} AudioCommand;
+
+// A voice played to its end (stopped voices are not reported), or a stream
+// the mixer let go of, for whatever reason. Streams report as voice
+// AUDIO_MAX_VOICES + their slot.
+typedef struct {
+  uint16_t voice;
+  uint16_t generation;
+} AudioCompletion;
+
+// Voice state owned by the audio thread
+typedef struct {
+  const int16_t *samples;
+  uint64_t frame_count;
+  uint64_t cursor;
+  uint64_t start_time;
+  uint32_t channels;
+  float volume, pan;
+  float gain_left, gain_right; // Volume and pan, times the s16 scale
+  uint16_t generation;
+  int16_t playing_index; // Position in AudioMixer::playing, -1 if idle
+} MixVoice;
+
+// Stream state owned by the audio thread
+typedef struct {
+  AudioStream *source; // nullptr while idle
+  uint64_t start_time;
+  bool started;     // First frames are in and the start time has passed
+  float volume;     // Current gain
+  float target;     // Gain the ramp ends on
+  float step;       // Per frame, while ramp_frames > 0
+  uint32_t ramp_frames;
+  bool stopping;    // Let go once the ramp reaches 0
+  uint16_t generation;
+} MixStream;
+
+typedef struct AudioMixer {
+  ma_node_base base; // First: miniaudio sees the mixer as a node
+
+  SPSCRing<AudioCommand, AUDIO_COMMAND_RING_SIZE> commands; // Game -> mixer
+  SPSCRing<AudioCompletion, AUDIO_COMPLETION_RING_SIZE> completions;
+
+  // Audio thread only
+  MixVoice voices[AUDIO_MAX_VOICES];
+  uint16_t playing[AUDIO_MAX_VOICES]; // Slots of the active voices, packed
+  int playing_count;
+  MixStream streams[AUDIO_MAX_STREAMS];
+
+  // Frames mixed so far (atomic, written by the mixer). Aligned by hand:
+  // i686 only aligns a uint64_t member to 4 bytes, and a 64-bit atomic
+  // that straddles a cache line is neither lock-free nor tear-free there.
+  uint64_t clock __attribute__((aligned(8)));
+
+  // No device: the game thread pulls every frame itself (offline render)
+  bool offline;
+} AudioMixer;
+
+static_assert(__atomic_always_lock_free(sizeof(uint64_t), 0),
+              "The mixer clock needs lock-free 64-bit atomics");
+
+// Creates the node and attaches it to the engine's endpoint. 'offline'
+// means the engine has no device and the caller's thread does the mixing.
+bool AudioMixer_Init(AudioMixer *mixer, ma_engine *engine, bool offline);
+void AudioMixer_Uninit(AudioMixer *mixer);
+
+// Game thread. Send only fails when the ring is full.
+bool AudioMixer_Send(AudioMixer *mixer, const AudioCommand *command);
+bool AudioMixer_Receive(AudioMixer *mixer, AudioCompletion *completion);
+
+// Waits until the mixer has applied every command sent so far, e.g. before
+// freeing frames that stopped voices were reading. Returns at once if the
+// device is not running: then nothing is mixed until the commands apply.
+// Offline, it applies them itself, as the only thread that mixes.
+void AudioMixer_Sync(AudioMixer *mixer);
+
+static inline uint64_t AudioMixer_Clock(const AudioMixer *mixer) {
+  return __atomic_load_n(&mixer->clock, __ATOMIC_ACQUIRE);
+}
+
+// Audio thread: applies pending commands, then mixes 'frame_count' frames
+// of every active voice into 'out' (overwritten) and advances the clock.
+void AudioMixer_Mix(AudioMixer *mixer, float *out, uint32_t frame_count);
+
+#endif // AUDIOMIXER_H
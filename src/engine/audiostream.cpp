@@ -0,0 +1,197 @@
+#include "audiostream.h"
+#include "audiomixer.h" // AUDIO_CHANNELS
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// --- Helper: Open the stream's file, stereo s16 at the mixer rate ---
+static bool OpenStream(AudioStream *stream, uint32_t sample_rate) {
+  ma_decoder_config config =
+      ma_decoder_config_init(ma_format_s16, AUDIO_CHANNELS, sample_rate);
+  if (ma_decoder_init_file(stream->path, &config, &stream->decoder) !=
+      MA_SUCCESS) {
+    std::cerr << "Failed to open music stream: " << stream->path << std::endl;
+    return false;
+  }
+  stream->decoder_open = true;
+  stream->position = 0;
+  std::cout << "Streaming: " << stream->path << std::endl;
+  return true;
+}
+
+// --- Helper: Mark the stream as finished once its frames are in ---
+static void EndStream(AudioStream *stream) {
+  __atomic_store_n(&stream->ended, 1, __ATOMIC_RELEASE);
+}
+
+// --- Helper: Decode into the ring while a whole chunk fits ---
+static void FillStream(AudioStream *stream) {
+  bool looped = false; // Guards against a loop region with no frames
+
+  while (true) {
+    uint32_t tail = stream->tail;
+    uint32_t head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+    if (AUDIO_STREAM_FRAMES - (tail - head) < AUDIO_STREAM_CHUNK)
+      return;
+
+    // 1. One chunk, cut at the ring's wrap and at the loop end
+    uint32_t at = tail & (AUDIO_STREAM_FRAMES - 1);
+    uint64_t count = AUDIO_STREAM_CHUNK;
+    if (count > AUDIO_STREAM_FRAMES - at)
+      count = AUDIO_STREAM_FRAMES - at;
+    bool at_loop_end = false;
+    if (stream->loop && stream->loop_end > stream->position &&
+        stream->loop_end - stream->position <= count) {
+      count = stream->loop_end - stream->position;
+      at_loop_end = true;
+    }
+
+    ma_uint64 read = 0;
+    ma_result result = ma_decoder_read_pcm_frames(
+        &stream->decoder, stream->frames + at * AUDIO_CHANNELS, count, &read);
+    stream->position += read;
+    __atomic_store_n(&stream->tail, tail + (uint32_t)read, __ATOMIC_RELEASE);
+    if (read > 0)
+      looped = false;
+
+    if (result == MA_SUCCESS && read == count && !at_loop_end)
+      continue;
+
+    // 2. End of the file (or of the loop region)
+    if (!stream->loop || looped ||
+        ma_decoder_seek_to_pcm_frame(&stream->decoder, stream->loop_start) !=
+            MA_SUCCESS) {
+      EndStream(stream);
+      return;
+    }
+    stream->position = stream->loop_start;
+    looped = true;
+  }
+}
+
+void AudioStreamer_Pump(AudioStreamer *streamer) {
+  for (int i = 0; i < AUDIO_MAX_STREAMS; i++) {
+    AudioStream *stream = &streamer->streams[i];
+    uint32_t state = __atomic_load_n(&stream->state, __ATOMIC_ACQUIRE);
+
+    // 1. Newly opened: a file that will not open simply ends
+    if (state == AUDIO_STREAM_OPENING) {
+      if (!OpenStream(stream, streamer->sample_rate))
+        EndStream(stream);
+      uint32_t expected = AUDIO_STREAM_OPENING;
+      __atomic_compare_exchange_n(&stream->state, &expected,
+                                  AUDIO_STREAM_RUNNING, false,
+                                  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+      state =
+          expected == AUDIO_STREAM_OPENING ? AUDIO_STREAM_RUNNING : expected;
+    }
+
+    // 2. Keep it topped up
+    if (state == AUDIO_STREAM_RUNNING && stream->decoder_open &&
+        !__atomic_load_n(&stream->ended, __ATOMIC_RELAXED))
+      FillStream(stream);
+
+    // 3. Closed by the game: hand the slot back
+    if (state == AUDIO_STREAM_CLOSING) {
+      if (stream->decoder_open)
+        ma_decoder_uninit(&stream->decoder);
+      stream->decoder_open = false;
+      __atomic_store_n(&stream->state, AUDIO_STREAM_FREE, __ATOMIC_RELEASE);
+    }
+  }
+}
+
+static void StreamerMain(void *user_data) {
+  AudioStreamer *streamer = (AudioStreamer *)user_data;
+  while (!__atomic_load_n(&streamer->quitting, __ATOMIC_ACQUIRE)) {
+    AudioStreamer_Pump(streamer);
+    Thread_Sleep(AUDIO_STREAM_POLL_MS);
+  }
+}
+
+bool AudioStreamer_Init(AudioStreamer *streamer, uint32_t sample_rate,
+                        bool threaded) {
+  memset(streamer, 0, sizeof(*streamer));
+  streamer->sample_rate = sample_rate;
+  streamer->threaded = threaded;
+
+  // 1. Every ring up front, nothing is allocated while streaming
+  size_t ring_bytes =
+      (size_t)AUDIO_STREAM_FRAMES * AUDIO_CHANNELS * sizeof(int16_t);
+  for (int i = 0; i < AUDIO_MAX_STREAMS; i++) {
+    streamer->streams[i].frames = (int16_t *)ma_malloc(ring_bytes, NULL);
+    if (!streamer->streams[i].frames) {
+      std::cerr << "Failed to allocate the music stream buffers."
+                << std::endl;
+      AudioStreamer_Shutdown(streamer);
+      return false;
+    }
+  }
+
+  // 2. The streamer thread, unless the caller pumps
+  if (threaded && !Thread_Create(&streamer->thread, StreamerMain, streamer)) {
+    std::cerr << "Failed to start the music streamer thread." << std::endl;
+    streamer->threaded = false;
+    AudioStreamer_Shutdown(streamer);
+    return false;
+  }
+  streamer->running = true;
+  return true;
+}
+
+void AudioStreamer_Shutdown(AudioStreamer *streamer) {
+  if (streamer->threaded) {
+    __atomic_store_n(&streamer->quitting, 1, __ATOMIC_RELEASE);
+    Thread_Join(&streamer->thread);
+    streamer->threaded = false;
+  }
+  streamer->running = false;
+
+  for (int i = 0; i < AUDIO_MAX_STREAMS; i++) {
+    AudioStream *stream = &streamer->streams[i];
+    if (stream->decoder_open)
+      ma_decoder_uninit(&stream->decoder);
+    stream->decoder_open = false;
+    ma_free(stream->frames, NULL);
+    stream->frames = nullptr;
+    stream->state = AUDIO_STREAM_FREE;
+  }
+}
+
+int AudioStreamer_Open(AudioStreamer *streamer, const char *path, bool loop,
+                       uint64_t loop_start, uint64_t loop_end) {
+  if (!streamer->running)
+    return -1;
+
+  for (int i = 0; i < AUDIO_MAX_STREAMS; i++) {
+    AudioStream *stream = &streamer->streams[i];
+    if (stream->in_mixer || __atomic_load_n(&stream->state, __ATOMIC_ACQUIRE) !=
+                                AUDIO_STREAM_FREE)
+      continue;
+
+    // Nobody else touches a free slot, so plain writes are fine until the
+    // state publishes them
+    snprintf(stream->path, sizeof(stream->path), "%s", path);
+    stream->loop = loop;
+    stream->loop_start = loop_start;
+    stream->loop_end = loop_end;
+    stream->head = 0;
+    stream->tail = 0;
+    stream->ended = 0;
+    stream->generation++;
+    __atomic_store_n(&stream->state, AUDIO_STREAM_OPENING, __ATOMIC_RELEASE);
+    return i;
+  }
+  return -1;
+}
+
+void AudioStreamer_Close(AudioStreamer *streamer, int index) {
+  if (index < 0 || index >= AUDIO_MAX_STREAMS)
+    return;
+  AudioStream *stream = &streamer->streams[index];
+  stream->in_mixer = false;
+
+  // Whether the streamer is still opening it or already running it, it
+  // sees CLOSING on its next pass
+  __atomic_store_n(&stream->state, AUDIO_STREAM_CLOSING, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,106 @@
+#ifndef AUDIOSTREAM_H
+#define AUDIOSTREAM_H
+
+#include "../vendor/miniaudio.h"
+#include "thread.h"
+#include <stdint.h>
+
+// Streaming playback for music and other long files.
+// A stream never holds the whole file: a streamer thread decodes it a
+// chunk at a time into a fixed ring of stereo s16 frames, and the mixer
+// (see audiomixer.h) plays straight out of that ring. Like SPSCRing, the
+// streamer only writes 'tail' and the mixer only writes 'head', so neither
+// waits for the other. A stream costs its ring (AUDIO_STREAM_FRAMES frames)
+// whatever the length of the file, and starts as soon as the first chunk
+// is in, instead of after a full decode.
+//
+// Looping jumps from the loop end back to the loop start inside the
+// streamer, so the ring holds one seamless run of frames and the mixer
+// never knows a stream loops.
+//
+// Ownership of a slot moves through 'state': the game thread opens it
+// (FREE -> OPENING), the streamer opens the decoder (-> RUNNING) and frees
+// it again once the game, after the mixer has let go, closes it
+// (-> CLOSING -> FREE).
+//
+// Offline (see AudioSystem_InitOffline) there is no streamer thread: the
+// render loop pumps the streams itself before every mix, so what a stream
+// plays does not depend on thread timing.
+
+#define AUDIO_MAX_STREAMS 4       // Two tracks crossfading, plus slack
+#define AUDIO_STREAM_FRAMES 16384 // Ring size, power of two (64 KB)
+#define AUDIO_STREAM_CHUNK 2048   // Frames decoded per step
+#define AUDIO_STREAM_POLL_MS 10   // Streamer wake-up interval
+#define AUDIO_STREAM_PATH_MAX 1024
+
+#define AUDIO_STREAM_FREE 0
+#define AUDIO_STREAM_OPENING 1
+#define AUDIO_STREAM_RUNNING 2
+#define AUDIO_STREAM_CLOSING 3
+
+typedef struct AudioStream {
+  // Frame ring, AUDIO_CHANNELS interleaved s16 per frame
+  int16_t *frames;
+  uint32_t head; // Next frame to mix (mixer)
+  uint8_t _padding[64 - sizeof(uint32_t)];
+  uint32_t tail;  // Next frame to fill (streamer)
+  uint32_t ended; // Set by the streamer after its last frame (atomic)
+  uint32_t state; // AUDIO_STREAM_* (atomic)
+
+  // Set by the game thread before OPENING, read by the streamer
+  char path[AUDIO_STREAM_PATH_MAX];
+  bool loop;
+  uint64_t loop_start; // Frames at the mixer rate
+  uint64_t loop_end;   // 0: end of the file
+
+  // Streamer only
+  ma_decoder decoder;
+  bool decoder_open;
+  uint64_t position; // Decoder frame the next read returns
+
+  // Game thread only
+  uint16_t generation; // Bumped whenever the slot is reopened
+  bool in_mixer;       // Handed to the mixer, not yet reported back
+} AudioStream;
+
+typedef struct AudioStreamer {
+  AudioStream streams[AUDIO_MAX_STREAMS];
+  uint32_t sample_rate;
+  Thread thread;
+  bool threaded;     // A streamer thread runs, else see AudioStreamer_Pump
+  bool running;      // Streams can be opened
+  uint32_t quitting; // Atomic
+} AudioStreamer;
+
+// Allocates every ring and, if 'threaded', starts the streamer thread.
+// Returns false (and leaves streaming unavailable) if either fails.
+bool AudioStreamer_Init(AudioStreamer *streamer, uint32_t sample_rate,
+                        bool threaded);
+// Joins the thread and frees everything; the mixer must no longer read any
+// stream.
+void AudioStreamer_Shutdown(AudioStreamer *streamer);
+
+// Game thread. Claims a free slot and has the streamer open 'path' (loop
+// points in frames at the mixer rate). Returns the slot, or -1 if every
+// slot is busy. A file that fails to open shows up as a stream that ends
+// at once.
+int AudioStreamer_Open(AudioStreamer *streamer, const char *path, bool loop,
+                       uint64_t loop_start, uint64_t loop_end);
+// Game thread, once the mixer has let go of the stream: the streamer
+// closes its decoder and frees the slot.
+void AudioStreamer_Close(AudioStreamer *streamer, int index);
+
+// Without a thread: opens, tops up and closes streams on the caller's
+// thread, exactly as one pass of the streamer thread would.
+void AudioStreamer_Pump(AudioStreamer *streamer);
+
+// Mixer side
+static inline uint32_t AudioStream_Available(const AudioStream *stream) {
+  return __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE) - stream->head;
+}
+
+static inline bool AudioStream_Ended(const AudioStream *stream) {
+  return __atomic_load_n(&stream->ended, __ATOMIC_ACQUIRE) != 0;
+}
+
+#endif // AUDIOSTREAM_H
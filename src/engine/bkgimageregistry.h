@@ -0,0 +1,10 @@
+#ifndef BKGIMAGEREGISTRY_H
+#define BKGIMAGEREGISTRY_H
+
+#include "assetregistry.h"
+#include "bkgimage.h"
+
+// Background images by name, e.g. "testbackground".
+typedef AssetRegistry<BkgImage> BkgImageRegistry;
+
+#endif // BKGIMAGEREGISTRY_H
@@ -0,0 +1,210 @@
+#include "blitter.h"
+#include "drawables.h"
+#include "pixelword.h"
+#include <string.h>
+
+// --- Helper: Clip 'height' rows placed at 'y' against the canvas ---
+// Returns the local row range [*row_start, *row_end) to visit with the
+// canvas' row step, keeping the interlace phase.
+static inline void ClipRows(const CanvasBuffer *canvas, int y, int height,
+                            int *row_start, int *row_end) {
+  int step = canvas->row_step;
+  int row = (step == 1 || (y & 1) == canvas->row_parity) ? 0 : 1;
+  if (y + row < 0)
+    row += ((-(y + row) + step - 1) / step) * step;
+
+  int end = canvas->height - y;
+  *row_start = row;
+  *row_end = end < height ? end : height;
+}
+
+void BlitSprite(const CanvasBuffer *canvas, const Sprite *sprite,
+                const Sprite *mask, int x, int y, uint32_t flags) {
+  int height = sprite->height;
+  int src_words = sprite->width_in_words;
+  int step = canvas->row_step;
+
+  // Interleaved sprites are their own mask: mask and ink words of a row sit
+  // next to each other, so both come from the same cache lines
+  const uint32_t *ink = Sprite_Ink(sprite);
+  int32_t ink_stride = Sprite_RowStride(sprite);
+  int32_t mask_stride = Sprite_RowStride(mask);
+
+  // 1. Vertical clip (keeping the interlace phase)
+  int row, row_end;
+  ClipRows(canvas, y, height, &row, &row_end);
+
+  // 2. Horizontal placement: each source word lands across two canvas words
+  int base_word = x >> 5; // Arithmetic shift: floor division for negative x
+  int shift = x & 31;
+  int canvas_words = canvas->width_in_words;
+  bool invert = (flags & DRAW_FLAG_INVERT);
+
+  // 3. Optional span table: visit only the words the mask covers
+  const SpriteRowSpan *spans = Sprite_Spans(mask);
+
+  for (; row < row_end; row += step) {
+    const uint32_t *s_row = ink + row * ink_stride;
+    const uint32_t *m_row = mask->pixels + row * mask_stride;
+    uint32_t *dst = canvas->words + (y + row) * canvas_words;
+
+    int first = 0;
+    int end = src_words;
+    if (spans) {
+      first = spans[row].first_word;
+      end = spans[row].end_word;
+
+      // Fully opaque row at an aligned x: the sprite words are the result
+      if (shift == 0 && !invert && (spans[row].flags & SPAN_FLAG_OPAQUE)) {
+        int from = first > -base_word ? first : -base_word;
+        int to = end < canvas_words - base_word ? end
+                                                : canvas_words - base_word;
+        if (from < to)
+          memcpy(dst + base_word + from, s_row + from,
+                 (to - from) * sizeof(uint32_t));
+        continue;
+      }
+    }
+
+    for (int i = first; i < end; i++) {
+      uint32_t m = LoadPixelWord(m_row + i);
+      if (m == 0)
+        continue;
+      uint32_t s = LoadPixelWord(s_row + i) & m;
+
+      // Split into the part landing in word d and the spill into word d + 1
+      uint32_t m_parts[2] = {m >> shift, shift ? m << (32 - shift) : 0};
+      uint32_t s_parts[2] = {s >> shift, shift ? s << (32 - shift) : 0};
+
+      for (int p = 0; p < 2; p++) {
+        int d = base_word + i + p;
+        if (m_parts[p] == 0 || d < 0 || d >= canvas_words)
+          continue;
+
+        if (invert) {
+          dst[d] ^= ToMemoryWord(s_parts[p]);
+        } else {
+          dst[d] = (dst[d] & ~ToMemoryWord(m_parts[p])) |
+                   ToMemoryWord(s_parts[p]);
+        }
+      }
+    }
+  }
+}
+
+void BlitShiftedSprite(const CanvasBuffer *canvas, const ShiftedSprite *variant,
+                       int x, int y, uint32_t flags) {
+  int words = variant->width_in_words;
+  int step = canvas->row_step;
+
+  // 1. Vertical clip (keeping the interlace phase)
+  int row, row_end;
+  ClipRows(canvas, y, variant->height, &row, &row_end);
+
+  // 2. Horizontal clip once: the variant covers canvas words from base_word on
+  int base_word = x >> 5;
+  int canvas_words = canvas->width_in_words;
+  int first = base_word < 0 ? -base_word : 0;
+  int last = canvas_words - base_word < words ? canvas_words - base_word
+                                               : words;
+  bool invert = (flags & DRAW_FLAG_INVERT);
+
+  const SpriteRowSpan *spans = variant->spans;
+  int spill = variant->shift ? 1 : 0;
+
+  for (; row < row_end; row += step) {
+    const uint32_t *m_row = variant->rows + row * words * 2;
+    const uint32_t *s_row = m_row + words;
+    uint32_t *dst = canvas->words + (y + row) * canvas_words;
+
+    // 3. Narrow to the words the mask covers (shifting spills into one more)
+    int from = first;
+    int to = last;
+    int full_from = 0;
+    int full_to = 0;
+    if (spans) {
+      const SpriteRowSpan &span = spans[row];
+      if (span.first_word > from)
+        from = span.first_word;
+      if (span.end_word + spill < to)
+        to = span.end_word + spill;
+
+      // Opaque rows: words strictly inside the run are completely replaced
+      if (span.flags & SPAN_FLAG_OPAQUE) {
+        full_from = span.first_word + spill;
+        full_to = span.end_word;
+        full_from = full_from > from ? full_from : from;
+        full_to = full_to < to ? full_to : to;
+      }
+    }
+
+    if (invert) {
+      for (int i = from; i < to; i++)
+        dst[base_word + i] ^= s_row[i];
+      continue;
+    }
+
+    if (full_from >= full_to)
+      full_from = full_to = to;
+
+    for (int i = from; i < full_from; i++)
+      dst[base_word + i] = (dst[base_word + i] & ~m_row[i]) | s_row[i];
+    if (full_from < full_to)
+      memcpy(dst + base_word + full_from, s_row + full_from,
+             (full_to - full_from) * sizeof(uint32_t));
+    for (int i = full_to; i < to; i++)
+      dst[base_word + i] = (dst[base_word + i] & ~m_row[i]) | s_row[i];
+  }
+}
+
+void BlitText(const CanvasBuffer *canvas, const BitmapFont *font, int x, int y,
+              const char *text, int length, uint32_t flags) {
+  int height = font->glyph_height;
+  int step = canvas->row_step;
+  int canvas_words = canvas->width_in_words;
+  bool invert = (flags & DRAW_FLAG_INVERT);
+
+  // Rows are shared by every glyph in the run, so clip them once
+  int row_start, row_end;
+  ClipRows(canvas, y, height, &row_start, &row_end);
+  if (row_start >= row_end)
+    return;
+
+  int pen_x = x;
+  for (int c = 0; c < length; c++) {
+    const uint32_t *glyph = Font_GlyphRows(font, text[c]);
+    int glyph_x = pen_x;
+    pen_x += Font_Advance(font, text[c]);
+
+    if (!glyph || glyph_x >= canvas->width)
+      continue;
+    if (glyph_x + font->glyph_width <= 0)
+      continue;
+
+    int d = glyph_x >> 5;
+    int shift = glyph_x & 31;
+
+    for (int row = row_start; row < row_end; row += step) {
+      uint32_t bits = glyph[row];
+      if (bits == 0)
+        continue;
+
+      uint32_t *dst = canvas->words + (y + row) * canvas_words;
+      uint32_t hi = bits >> shift;
+      uint32_t lo = shift ? bits << (32 - shift) : 0;
+
+      if (hi && d >= 0 && d < canvas_words) {
+        if (invert)
+          dst[d] ^= ToMemoryWord(hi);
+        else
+          dst[d] |= ToMemoryWord(hi);
+      }
+      if (lo && d + 1 >= 0 && d + 1 < canvas_words) {
+        if (invert)
+          dst[d + 1] ^= ToMemoryWord(lo);
+        else
+          dst[d + 1] |= ToMemoryWord(lo);
+      }
+    }
+  }
+}
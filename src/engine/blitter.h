@@ -0,0 +1,41 @@
+#ifndef BLITTER_H
+#define BLITTER_H
+
+#include "font.h"
+#include "shiftcache.h"
+#include "sprite.h"
+#include <stdint.h>
+
+// A 1bpp software canvas. Rows use the same MSB-first layout as Sprite and
+// BkgImage pixels (1 = ink/black), so backgrounds are a straight memcpy and
+// the buffer can be handed to the platform as-is (DIB, XYBitmap, texture).
+typedef struct CanvasBuffer {
+  uint32_t *words;
+  int32_t width;  // Multiple of 32
+  int32_t height;
+  int32_t width_in_words;
+
+  // Rows that may be written this frame. Interlaced backends set a step of 2
+  // and the parity of the current phase; everything else uses 1 / 0.
+  int32_t row_step;
+  int32_t row_parity;
+} CanvasBuffer;
+
+// Draws 'sprite' through 'mask' with its top-left corner at (x, y).
+// Opaque mask pixels are painted ink or paper, or only the ink is XORed in
+// when DRAW_FLAG_INVERT is set. Works one canvas word at a time and clips
+// against the canvas edges.
+void BlitSprite(const CanvasBuffer *canvas, const Sprite *sprite,
+                const Sprite *mask, int x, int y, uint32_t flags);
+
+// Same as BlitSprite for a pre-shifted variant (see ShiftCache). The
+// variant was built for x & 31, so every row is aligned word ANDs / ORs.
+void BlitShiftedSprite(const CanvasBuffer *canvas, const ShiftedSprite *variant,
+                       int x, int y, uint32_t flags);
+
+// Draws the first 'length' characters of 'text' with the pen starting at
+// (x, y). Only glyph ink is written (ORed, or XORed with DRAW_FLAG_INVERT).
+void BlitText(const CanvasBuffer *canvas, const BitmapFont *font, int x, int y,
+              const char *text, int length, uint32_t flags);
+
+#endif // BLITTER_H
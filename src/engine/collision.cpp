@@ -0,0 +1,66 @@
+#include "collision.h"
+#include "pixelword.h"
+
+// --- Helper: Fetch 32 pixels of a row starting at an arbitrary bit ---
+// Bits past the end of the row read as transparent.
+static inline uint32_t FetchRowBits(const uint32_t *row, int32_t width_in_words,
+                                    int bit_offset) {
+  int word = bit_offset >> 5;
+  int shift = bit_offset & 31;
+
+  uint32_t hi = LoadPixelWord(row + word);
+  if (shift == 0)
+    return hi;
+
+  uint32_t lo = (word + 1 < width_in_words) ? LoadPixelWord(row + word + 1) : 0;
+  return (hi << shift) | (lo >> (32 - shift));
+}
+
+bool SpriteMasksOverlap(const Sprite *mask_a, int ax, int ay,
+                        const Sprite *mask_b, int bx, int by,
+                        CollisionPoint *contact) {
+  if (!mask_a || !mask_b)
+    return false;
+
+  // 1. AABB reject
+  int x0 = ax > bx ? ax : bx;
+  int y0 = ay > by ? ay : by;
+  int x1 = (ax + mask_a->width) < (bx + mask_b->width) ? (ax + mask_a->width)
+                                                       : (bx + mask_b->width);
+  int y1 = (ay + mask_a->height) < (by + mask_b->height)
+               ? (ay + mask_a->height)
+               : (by + mask_b->height);
+
+  if (x0 >= x1 || y0 >= y1)
+    return false;
+
+  // Interleaved sprites store the mask words first in every row
+  int32_t stride_a = Sprite_RowStride(mask_a);
+  int32_t stride_b = Sprite_RowStride(mask_b);
+
+  // 2. Word-parallel AND over the intersecting rows only
+  for (int y = y0; y < y1; y++) {
+    const uint32_t *row_a = mask_a->pixels + (y - ay) * stride_a;
+    const uint32_t *row_b = mask_b->pixels + (y - by) * stride_b;
+
+    for (int x = x0; x < x1; x += 32) {
+      uint32_t bits = FetchRowBits(row_a, mask_a->width_in_words, x - ax) &
+                      FetchRowBits(row_b, mask_b->width_in_words, x - bx);
+
+      // Trim the last partial word to the overlap rectangle
+      int remaining = x1 - x;
+      if (remaining < 32)
+        bits &= ~(0xFFFFFFFFu >> remaining);
+
+      if (bits) {
+        if (contact) {
+          contact->x = (int16_t)(x + __builtin_clz(bits));
+          contact->y = (int16_t)y;
+        }
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,32 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "sprite.h"
+#include <stdint.h>
+
+// First overlapping pixel found by a pixel-perfect test, in canvas
+// coordinates. Rows are scanned top to bottom, pixels left to right.
+typedef struct {
+  int16_t x;
+  int16_t y;
+} CollisionPoint;
+
+// Pixel-perfect overlap test between two 1bpp masks placed at (ax, ay) and
+// (bx, by). Rejects on the bounding boxes first, then ANDs the masks one
+// 32-pixel word at a time over the intersecting rows only.
+// Returns true on the first overlapping pixel. 'contact' is optional.
+bool SpriteMasksOverlap(const Sprite *mask_a, int ax, int ay,
+                        const Sprite *mask_b, int bx, int by,
+                        CollisionPoint *contact);
+
+// Convenience wrapper for anything built from DRAWABLE_BODY (any layer).
+// Uses the drawable's mask, since that is what defines its silhouette.
+template <typename DrawableA, typename DrawableB>
+inline bool DrawablesOverlap(const DrawableA &a, const DrawableB &b,
+                             CollisionPoint *contact) {
+  if (!a.mask || !b.mask)
+    return false;
+  return SpriteMasksOverlap(a.mask, a.x, a.y, b.mask, b.x, b.y, contact);
+}
+
+#endif // COLLISION_H
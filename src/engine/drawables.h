@@ -27,6 +27,7 @@ typedef struct Sprite Sprite;
   int16_t x;         /* 2 bytes (Offset 28) */                                 \
   int16_t y;         /* 2 bytes (Offset 30) */
 // NOTE THAT THE MASK IS NOT OPTIONAL!
+// Use Sprite_Mask(sprite): the mask loaded with the sprite, or the sprite.
 
 // --- Layer 1: Background Objects (Parallax, Clouds, Distant Mountains) ---
 // Rendered after the base canvas fill, but before the isometric world.
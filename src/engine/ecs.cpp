@@ -14,16 +14,23 @@ EntityID Registry::create_entity() {
     entities[id].active = true;
     entities[id].drawable = {DrawableType::NONE, -1};
     entities[id].displaceable = {false, 0, 0, 0, 0};
+    entities[id].animator_index = -1;
+    entities[id].emitter_index = -1;
     return id;
   }
 
   EntityID id = (EntityID)entities.size();
-  entities.push_back({true, {DrawableType::NONE, -1}, {false, 0, 0, 0, 0}});
+  entities.push_back(
+      {true, {DrawableType::NONE, -1}, {false, 0, 0, 0, 0}, -1, -1});
   return id;
 }
 
 void Registry::destroy_entity(EntityID id) {
   if (id < entities.size() && entities[id].active) {
+    if (destroy_callback)
+      destroy_callback(id, destroy_user_data);
+    remove_animator(id);
+    remove_audio_emitter(id);
     entities[id].active = false;
     entities[id].drawable = {DrawableType::NONE, -1};
     entities[id].displaceable = {false, 0, 0, 0, 0};
@@ -31,6 +38,12 @@ void Registry::destroy_entity(EntityID id) {
   }
 }
 
+void Registry::set_destroy_callback(EntityDestroyCallback callback,
+                                   void *user_data) {
+  destroy_callback = callback;
+  destroy_user_data = user_data;
+}
+
 void Registry::set_drawable_ref(EntityID id, DrawableType type, int index) {
   if (id < entities.size() && entities[id].active) {
     entities[id].drawable.type = type;
@@ -71,6 +84,17 @@ void Registry::set_displaceable(EntityID id, float x, float y, float vx,
   entities[id].displaceable.vy = vy;
 }
 
+DisplaceableComponent *Registry::add_displaceable(EntityID id) {
+  if (id >= entities.size() || !entities[id].active) {
+    return nullptr;
+  }
+  DisplaceableComponent &d = entities[id].displaceable;
+  if (!d.active) {
+    d = {true, 0, 0, 0, 0};
+  }
+  return &d;
+}
+
 void Registry::update_drawable_index(EntityID owner_id, int new_index) {
   if (owner_id < entities.size() && entities[owner_id].active) {
     // Debug check: ensure we are updating the right thing?
@@ -81,3 +105,102 @@ void Registry::update_drawable_index(EntityID owner_id, int new_index) {
               << " not found or inactive during swap-update." << std::endl;
   }
 }
+
+void Registry::set_animator(EntityID id, const AnimationClip *clip) {
+  if (id >= entities.size() || !entities[id].active) {
+    return;
+  }
+
+  int index = entities[id].animator_index;
+  if (index < 0) {
+    index = (int)animators.size();
+    animators.push_back({id, nullptr, 0, 0, false});
+    entities[id].animator_index = index;
+  }
+
+  AnimatorComponent &a = animators[index];
+  a.clip = clip;
+  a.frame = 0;
+  a.ticks_left = 0; // Applies frame 0 on the next system update
+  a.playing = (clip != nullptr);
+}
+
+AnimatorComponent *Registry::get_animator(EntityID id) {
+  if (id >= entities.size() || !entities[id].active) {
+    return nullptr;
+  }
+  int index = entities[id].animator_index;
+  if (index < 0) {
+    return nullptr;
+  }
+  return &animators[index];
+}
+
+void Registry::remove_animator(EntityID id) {
+  if (id >= entities.size()) {
+    return;
+  }
+  int index = entities[id].animator_index;
+  if (index < 0) {
+    return;
+  }
+
+  // Swap-and-pop, keeping the moved animator's back-reference valid
+  int last_index = (int)animators.size() - 1;
+  if (index != last_index) {
+    animators[index] = animators[last_index];
+    entities[animators[index].owner].animator_index = index;
+  }
+  animators.pop_back();
+  entities[id].animator_index = -1;
+}
+
+void Registry::set_audio_emitter(EntityID id, VoiceHandle voice,
+                                 float volume) {
+  if (id >= entities.size() || !entities[id].active) {
+    return;
+  }
+
+  int index = entities[id].emitter_index;
+  if (index < 0) {
+    index = (int)audio_emitters.size();
+    audio_emitters.push_back({id, 0, 0, 0, 0});
+    entities[id].emitter_index = index;
+  }
+
+  AudioEmitterComponent &e = audio_emitters[index];
+  e.voice = voice;
+  e.volume = volume;
+  e.sent_volume = -1; // Sent on the next system update
+  e.sent_pan = 0;
+}
+
+AudioEmitterComponent *Registry::get_audio_emitter(EntityID id) {
+  if (id >= entities.size() || !entities[id].active) {
+    return nullptr;
+  }
+  int index = entities[id].emitter_index;
+  if (index < 0) {
+    return nullptr;
+  }
+  return &audio_emitters[index];
+}
+
+void Registry::remove_audio_emitter(EntityID id) {
+  if (id >= entities.size()) {
+    return;
+  }
+  int index = entities[id].emitter_index;
+  if (index < 0) {
+    return;
+  }
+
+  // Swap-and-pop, keeping the moved emitter's back-reference valid
+  int last_index = (int)audio_emitters.size() - 1;
+  if (index != last_index) {
+    audio_emitters[index] = audio_emitters[last_index];
+    entities[audio_emitters[index].owner].emitter_index = index;
+  }
+  audio_emitters.pop_back();
+  entities[id].emitter_index = -1;
+}
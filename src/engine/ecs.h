@@ -21,6 +21,35 @@ struct DisplaceableComponent {
   float vx, vy;
 };
 
+struct AnimationClip;
+
+// Stored densely (not per entity) so the animation system can walk every
+// animator in one pass without touching inactive entities.
+struct AnimatorComponent {
+  EntityID owner;
+  const AnimationClip *clip;
+  uint16_t frame;      // Current frame in clip
+  uint16_t ticks_left; // Ticks until the next frame
+  bool playing;
+};
+
+typedef uint32_t VoiceHandle; // See audio.h
+
+// Called by Registry::destroy_entity while the entity is still alive, so
+// state kept outside the registry (e.g. script behaviours) can follow it
+typedef void (*EntityDestroyCallback)(EntityID id, void *user_data);
+
+// A sound that follows its entity: the spatial audio system (see
+// spatialaudio.h) sets the voice's volume and pan from the entity's position
+// every tick. Stored densely, like animators.
+struct AudioEmitterComponent {
+  EntityID owner;
+  VoiceHandle voice; // 0 once the voice has ended
+  float volume;      // Volume at the listener, before distance attenuation
+  float sent_volume; // Last volume and pan sent to the mixer; a negative
+  float sent_pan;    // volume forces the next update to send
+};
+
 class Registry {
 public:
   Registry();
@@ -29,6 +58,14 @@ public:
   // Entity Management
   EntityID create_entity();
   void destroy_entity(EntityID id);
+  bool is_alive(EntityID id) const {
+    return id < entities.size() && entities[id].active;
+  }
+  // Every id handed out so far is below this
+  EntityID id_limit() const { return (EntityID)entities.size(); }
+
+  // One listener; nullptr removes it
+  void set_destroy_callback(EntityDestroyCallback callback, void *user_data);
 
   // Component Access (Simple array-of-structs or similar for now)
   // For this task, we focus on storing the link to drawables.
@@ -44,19 +81,53 @@ public:
   // Displaceable Components
   void set_displaceable(EntityID id, float x, float y, float vx, float vy);
   DisplaceableComponent *get_displaceable(EntityID id);
+  // Like get_displaceable, but gives the entity a zeroed one if it has none.
+  // nullptr only for dead entities.
+  DisplaceableComponent *add_displaceable(EntityID id);
 
   // Call this when the Engine moves a drawable in memory
   void update_drawable_index(EntityID owner_id, int new_index);
 
+  // Animator Components
+  // Starts 'clip' from its first frame (replacing any running clip).
+  void set_animator(EntityID id, const AnimationClip *clip);
+  AnimatorComponent *get_animator(EntityID id);
+  void remove_animator(EntityID id);
+
+  // Dense array for systems. Removal swaps the last animator into the gap.
+  AnimatorComponent *animators_data() { return animators.data(); }
+  int animators_count() const { return (int)animators.size(); }
+
+  // Audio Emitter Components
+  // Attaches 'voice' to the entity (replacing any previous one, which keeps
+  // playing where it is). Destroying the entity detaches it the same way.
+  void set_audio_emitter(EntityID id, VoiceHandle voice, float volume);
+  AudioEmitterComponent *get_audio_emitter(EntityID id);
+  void remove_audio_emitter(EntityID id);
+
+  // Dense array for systems. Removal swaps the last emitter into the gap.
+  AudioEmitterComponent *audio_emitters_data() {
+    return audio_emitters.data();
+  }
+  int audio_emitters_count() const { return (int)audio_emitters.size(); }
+
 private:
   struct EntityData {
     bool active;
     DrawableComponent drawable;
     DisplaceableComponent displaceable;
+    int animator_index; // Index into 'animators', -1 if none
+    int emitter_index;  // Index into 'audio_emitters', -1 if none
   };
 
   std::vector<EntityData> entities;
   std::vector<EntityID> free_ids;
+
+  std::vector<AnimatorComponent> animators;
+  std::vector<AudioEmitterComponent> audio_emitters;
+
+  EntityDestroyCallback destroy_callback = nullptr;
+  void *destroy_user_data = nullptr;
 };
 
 #endif // ECS_H
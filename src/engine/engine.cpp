@@ -1,9 +1,207 @@
 #include "engine.h"
+#include "audio.h"
+#include "blitter.h"
 #include "ecs.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
+Engine::Engine() {
+  Arena_Init(&frame_arenas[0], "FrameArena[0]", FRAME_ARENA_SIZE,
+             ARENA_BACKING_HEAP);
+  Arena_Init(&frame_arenas[1], "FrameArena[1]", FRAME_ARENA_SIZE,
+             ARENA_BACKING_HEAP);
+}
+
+Engine::~Engine() {
+  if (audio) {
+    AudioSystem_Shutdown(audio);
+    delete audio;
+  }
+  Arena_Release(&frame_arenas[0]);
+  Arena_Release(&frame_arenas[1]);
+}
+
 void Engine::set_registry(Registry *reg) { registry = reg; }
 
+bool Engine::init_audio(const char *base_dir) {
+  if (!audio)
+    audio = new AudioSystem();
+  return AudioSystem_Init(audio, base_dir);
+}
+
+bool Engine::init_audio_offline(const char *base_dir) {
+  if (!audio)
+    audio = new AudioSystem();
+  return AudioSystem_InitOffline(audio, base_dir, 0);
+}
+
+void Engine::render_audio(float *out, uint32_t frame_count) {
+  if (audio)
+    AudioSystem_Render(audio, out, frame_count);
+  else
+    memset(out, 0, (size_t)frame_count * AUDIO_CHANNELS * sizeof(float));
+}
+
+void Engine::update_audio() {
+  if (audio)
+    AudioSystem_Update(audio, get_time_ms());
+}
+
+VoiceHandle Engine::play_sound(SoundID sound) {
+  return audio ? AudioSystem_Play(audio, sound) : 0;
+}
+
+VoiceHandle Engine::play_sound(const char *filename) {
+  return audio ? AudioSystem_Play(audio, AudioSystem_Load(audio, filename))
+               : 0;
+}
+
+void Engine::stop_sound(VoiceHandle voice) {
+  if (audio)
+    AudioSystem_Stop(audio, voice);
+}
+
+bool Engine::is_sound_playing(VoiceHandle voice) {
+  return audio && AudioSystem_IsPlaying(audio, voice);
+}
+
+void Engine::set_sound_volume(VoiceHandle voice, float volume) {
+  if (audio)
+    AudioSystem_SetVolume(audio, voice, volume);
+}
+
+void Engine::set_sound_pan(VoiceHandle voice, float pan) {
+  if (audio)
+    AudioSystem_SetPan(audio, voice, pan);
+}
+
+void Engine::set_sound_params(VoiceParams *params, int count) {
+  if (audio)
+    AudioSystem_SetVoiceParams(audio, params, count);
+  else
+    memset(params, 0, sizeof(VoiceParams) * count);
+}
+
+void Engine::set_sound_polyphony(SoundID sound, int max_voices) {
+  if (audio)
+    AudioSystem_SetPolyphony(audio, sound, max_voices);
+}
+
+void Engine::set_voice_steal_mode(int mode) {
+  if (audio)
+    AudioSystem_SetStealMode(audio, mode);
+}
+
+SoundID Engine::load_sound(const char *filename) {
+  return audio ? AudioSystem_Load(audio, filename) : 0;
+}
+
+SoundID Engine::load_sound_memory(const char *name, const void *data,
+                                  size_t size) {
+  return audio ? AudioSystem_LoadMemory(audio, name, data, size) : 0;
+}
+
+uint32_t Engine::get_audio_sample_rate() {
+  return audio ? AudioSystem_SampleRate(audio) : 0;
+}
+
+const char *Engine::get_audio_base_dir() {
+  return audio ? audio->base_dir : ".";
+}
+
+void Engine::cache_decoded_sound(const char *name, const SoundData *data) {
+  if (audio)
+    AudioSystem_CacheDecoded(audio, name, data);
+  else
+    ma_free(data->samples, NULL);
+}
+
+bool Engine::reload_sound(const char *filename) {
+  return audio && AudioSystem_Reload(audio, filename) != 0;
+}
+
+void Engine::unload_sound(const char *filename) {
+  if (audio)
+    AudioSystem_Unload(audio, filename);
+}
+
+void Engine::clear_sounds() {
+  if (audio)
+    AudioSystem_Clear(audio);
+}
+
+bool Engine::play_music(const char *filename, uint32_t fade_ms, bool loop,
+                        uint32_t loop_start_ms, uint32_t loop_end_ms) {
+  return audio && AudioSystem_PlayMusic(audio, filename, loop, loop_start_ms,
+                                        loop_end_ms, fade_ms);
+}
+
+void Engine::stop_music(uint32_t fade_ms) {
+  if (audio)
+    AudioSystem_StopMusic(audio, fade_ms);
+}
+
+void Engine::set_music_volume(float volume) {
+  if (audio)
+    AudioSystem_SetMusicVolume(audio, volume);
+}
+
+bool Engine::is_music_playing() {
+  return audio && AudioSystem_IsMusicPlaying(audio);
+}
+
+void Engine::begin_frame() {
+  frame_index ^= 1;
+  Arena_Rewind(&frame_arenas[frame_index], 0);
+}
+
+const char *Engine::frame_format(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  va_list measure;
+  va_copy(measure, args);
+  int length = vsnprintf(nullptr, 0, format, measure);
+  va_end(measure);
+
+  char *result = nullptr;
+  if (length >= 0)
+    result = (char *)Arena_Alloc(frame_arena(), (size_t)length + 1, 0);
+  if (result)
+    vsnprintf(result, (size_t)length + 1, format, args);
+
+  va_end(args);
+  return result;
+}
+
+// --- Helper: Re-point one drawable layer ---
+template <typename Drawable>
+static int ReplaceSpriteInLayer(Drawable *drawables, int count,
+                                const Sprite *old_sprite, Sprite *new_sprite) {
+  int changed = 0;
+  for (int i = 0; i < count; i++) {
+    if (drawables[i].sprite == old_sprite) {
+      drawables[i].sprite = new_sprite;
+      changed++;
+    }
+    if (drawables[i].mask == old_sprite) {
+      drawables[i].mask = new_sprite;
+      changed++;
+    }
+  }
+  return changed;
+}
+
+int Engine::replace_sprite(const Sprite *old_sprite, Sprite *new_sprite) {
+  return ReplaceSpriteInLayer(background_drawables, background_drawables_count,
+                              old_sprite, new_sprite) +
+         ReplaceSpriteInLayer(world_drawables, world_drawables_count,
+                              old_sprite, new_sprite) +
+         ReplaceSpriteInLayer(foreground_drawables, foreground_drawables_count,
+                              old_sprite, new_sprite);
+}
+
 int Engine::add_world_drawable(WorldDrawable &d) {
   if (world_drawables_count >= MAX_WORLD_DRAWABLES) {
     std::cerr << "Engine Error: World drawable limit reached!" << std::endl;
@@ -75,6 +273,64 @@ void Engine::remove_foreground_drawable(int index) {
   foreground_drawables_count--;
 }
 
+bool Engine::queue_text(const BitmapFont *font, int x, int y, const char *text,
+                        uint32_t flags) {
+  if (!font || !text)
+    return false;
+
+  int length = (int)strlen(text);
+  if (text_runs_count >= MAX_TEXT_RUNS) {
+    std::cerr << "Engine Error: Text queue full!" << std::endl;
+    return false;
+  }
+
+  char *stored = (char *)Arena_Alloc(frame_arena(), length, 0);
+  if (!stored)
+    return false;
+  memcpy(stored, text, length);
+
+  TextRun &run = text_runs[text_runs_count++];
+  run.font = font;
+  run.text = stored;
+  run.flags = flags;
+  run.x = (int16_t)x;
+  run.y = (int16_t)y;
+  run.length = length;
+  return true;
+}
+
+void Engine::clear_text() { text_runs_count = 0; }
+
+void Engine::rasterize_lists(const CanvasBuffer *canvas) {
+  // Foreground drawables
+  for (int i = 0; i < foreground_drawables_count; i++) {
+    ForegroundDrawable &fd = foreground_drawables[i];
+    if (!fd.sprite || !fd.mask)
+      continue;
+
+    if (fd.flags & DRAW_FLAG_HIDDEN)
+      continue;
+
+    // Word-aligned sprites already blit without shifting
+    if (shift_cache && (fd.x & 31)) {
+      const ShiftedSprite *variant =
+          ShiftCache_Get(shift_cache, fd.sprite, fd.mask, fd.x & 31);
+      if (variant) {
+        BlitShiftedSprite(canvas, variant, fd.x, fd.y, fd.flags);
+        continue;
+      }
+    }
+
+    BlitSprite(canvas, fd.sprite, fd.mask, fd.x, fd.y, fd.flags);
+  }
+
+  // Text runs, on top of everything
+  for (int i = 0; i < text_runs_count; i++) {
+    TextRun &run = text_runs[i];
+    BlitText(canvas, run.font, run.x, run.y, run.text, run.length, run.flags);
+  }
+}
+
 void Engine::toggle_interlace() {
   interlaced_mode = !interlaced_mode;
   std::cout << "Interlaced Mode: " << (interlaced_mode ? "ON" : "OFF")
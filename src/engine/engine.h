@@ -1,16 +1,27 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 
+#include "arena.h"
 #include "drawables.h"
+#include "font.h"
 #include <functional>
 #include <string>
 #include <unistd.h>
 
 class Registry; // Forward declaration
+struct AudioSystem;
+struct SoundData;
+struct VoiceParams;
+struct CanvasBuffer;
+struct ShiftCache;
+
+typedef uint32_t VoiceHandle; // See audio.h
+typedef uint64_t SoundID;     // See audio.h
 
 class Engine {
 public:
-  virtual ~Engine() {}
+  Engine();
+  virtual ~Engine();
 
   // Registry for ECS updates
   void set_registry(Registry *reg);
@@ -46,6 +57,10 @@ public:
   int add_foreground_drawable(struct ForegroundDrawable &d);
   void remove_foreground_drawable(int index);
 
+  // Points every drawable (any layer) that uses 'old_sprite' as its sprite
+  // or mask at 'new_sprite' instead. Returns how many were changed.
+  int replace_sprite(const Sprite *old_sprite, Sprite *new_sprite);
+
   ForegroundDrawable *get_foreground_drawable(int index) {
     if (index < 0 || index >= foreground_drawables_count)
       return nullptr;
@@ -69,6 +84,42 @@ public:
   struct ForegroundDrawable foreground_drawables[MAX_FOREGROUND_DRAWABLES];
   int foreground_drawables_count = 0;
 
+  // Text (Layer 3, immediate mode)
+  // Strings are copied into the frame arena, so callers may pass temporaries.
+  // Runs are drawn on top of the foreground drawables and dropped once the
+  // frame has been presented. Returns false if the queue or arena is full.
+  bool queue_text(const struct BitmapFont *font, int x, int y, const char *text,
+                  uint32_t flags);
+  void clear_text();
+
+  static const int MAX_TEXT_RUNS = 64;
+
+  TextRun text_runs[MAX_TEXT_RUNS];
+  int text_runs_count = 0;
+
+  // Frame arenas (scratch memory for backends, systems and Lua bindings)
+  // Allocations live until the end of the *next* frame: the two arenas
+  // alternate and only the one being entered is rewound, so data handed off
+  // during frame N (e.g. to the audio thread) survives frame N + 1.
+  // Nothing here is ever freed individually; use it instead of the heap for
+  // anything that does not outlive a frame.
+  static const size_t FRAME_ARENA_SIZE = 512 * 1024;
+
+  Arena *frame_arena() { return &frame_arenas[frame_index]; }
+  void begin_frame();
+
+  // printf into the frame arena. Returns nullptr if the arena is full.
+  const char *frame_format(const char *format, ...)
+      __attribute__((format(printf, 2, 3)));
+
+  Arena frame_arenas[2];
+  int frame_index = 0;
+
+  // Optional pre-shifted sprite cache used by the rasterizer for sprites at
+  // x positions that are not word aligned. nullptr disables it.
+  void set_shift_cache(struct ShiftCache *cache) { shift_cache = cache; }
+  struct ShiftCache *shift_cache = nullptr;
+
   // TODO make an on-demand sort function for BackgroundDrawables and
   // ForegroundDrawables that sorts by z-index (sort key). DO NOT INCLUDE THE
   // SORT IN THE RENDERING LOOP!
@@ -83,10 +134,12 @@ public:
   // Template prevents circular dependency on Game type
   template <typename GameApp> void start(GameApp &game) {
     run_loop([&]() {
+      begin_frame();
       game.update(*this);
       draw_start();
       draw_lists();
       draw_end();
+      clear_text();
     });
   }
 
@@ -100,10 +153,56 @@ public:
   virtual unsigned long get_time_ms() = 0;
   virtual void sleep_ms(int ms) = 0;
 
-  // Audio configuration
-  virtual void play_sound(const char *filename) = 0;
-  virtual void load_sound(const char *filename) = 0;
-  virtual void clear_sounds() = 0;
+  // Audio (shared by every backend, see audio.h)
+  // Returns a handle to the new voice, or 0 if nothing could be played.
+  // Voices come from a fixed pool; when it is full an older voice is cut.
+  // Play by the SoundID load_sound returned (or ASSET_ID(filename)): the
+  // filename overload hashes the name and loads it on first use.
+  VoiceHandle play_sound(SoundID sound);
+  VoiceHandle play_sound(const char *filename);
+  void stop_sound(VoiceHandle voice);
+  bool is_sound_playing(VoiceHandle voice);
+  void set_sound_volume(VoiceHandle voice, float volume);
+  void set_sound_pan(VoiceHandle voice, float pan); // -1 left .. 1 right
+  // Volume and pan of 'count' voices at once (see AudioSystem_SetVoiceParams);
+  // ended voices come back with their handle set to 0.
+  void set_sound_params(struct VoiceParams *params, int count);
+  // Caps how many voices 'sound' (the SoundID load_sound returned, or
+  // ASSET_ID(filename)) may use at once; the oldest restarts beyond that.
+  // E.g. for a sound fired on every collision. No-op if it is not loaded.
+  void set_sound_polyphony(SoundID sound, int max_voices);
+  // AUDIO_STEAL_OLDEST (default) or AUDIO_STEAL_QUIETEST, see audio.h
+  void set_voice_steal_mode(int mode);
+  // Returns the sound's ID, or 0 if it could not be loaded.
+  SoundID load_sound(const char *filename);
+  // Decodes an encoded sound file already in memory (e.g. from an asset
+  // pack) and caches it under 'name'. 'data' is not referenced afterwards.
+  SoundID load_sound_memory(const char *name, const void *data, size_t size);
+  // Device rate that sounds are decoded to, or 0 without audio. Lets the
+  // asset loader decode on a worker thread.
+  uint32_t get_audio_sample_rate();
+  // Where sound file names are resolved (see init_audio); "." without audio
+  const char *get_audio_base_dir();
+  // Takes ownership of a sound decoded at get_audio_sample_rate() (see
+  // SoundData_DecodeFile) and caches it under 'name'.
+  void cache_decoded_sound(const char *name, const struct SoundData *data);
+  // Reads 'filename' again, keeping its ID and polyphony (hot reload).
+  bool reload_sound(const char *filename);
+  // Stops the voices playing 'filename' and drops it from the cache, so the
+  // next load_sound reads it again.
+  void unload_sound(const char *filename);
+  void clear_sounds();
+
+  // Music, streamed from disk rather than cached. A new track crossfades
+  // from the current one over 'fade_ms' (0 cuts). A looping track jumps
+  // from 'loop_end_ms' (0: the end of the file) back to 'loop_start_ms'.
+  bool play_music(const char *filename, uint32_t fade_ms, bool loop,
+                  uint32_t loop_start_ms, uint32_t loop_end_ms);
+  void stop_music(uint32_t fade_ms);
+  void set_music_volume(float volume);
+  bool is_music_playing();
+
+  struct AudioSystem *audio = nullptr;
 
   // Background Management
   virtual void set_active_background(struct BkgImage *bkg) = 0;
@@ -114,6 +213,21 @@ public:
   virtual int get_height() const = 0;
 
 protected:
+  // Backends open the audio device from init() ('base_dir' is where sound
+  // file names are resolved) and, once per frame before the game runs,
+  // reclaim finished voices and stamp the frame's audio start time.
+  // The device is closed by ~Engine.
+  bool init_audio(const char *base_dir);
+  void update_audio();
+  // Headless backends mix offline instead (see AudioSystem_InitOffline):
+  // render_audio pulls the next 'frame_count' stereo frames into 'out'.
+  bool init_audio_offline(const char *base_dir);
+  void render_audio(float *out, uint32_t frame_count);
+
+  // Software rasterization shared by every backend: draws the foreground
+  // drawables and queued text into the backend's 1bpp canvas.
+  void rasterize_lists(const CanvasBuffer *canvas);
+
   // Run the main game loop with a provided callback
   void run_loop(std::function<void()> loop_body) {
     while (process_events()) {
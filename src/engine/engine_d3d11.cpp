@@ -7,13 +7,12 @@
 #include <cstring>
 #include <ctime>
 #include <iostream>
-#include <map>
 #include <string>
 #include <vector>
 #include <windows.h>
 
-#include "../vendor/miniaudio.h"
 #include "bkgimage.h"
+#include "blitter.h"
 #include "engine.h"
 #include "sprite.h"
 
@@ -110,24 +109,7 @@ private:
   BkgImage *active_background;
   BkgImage *default_background;
 
-  // Audio State
-  ma_engine audio_engine;
-  bool audio_initialized;
-
-  struct CachedSound {
-    void *pData;
-    ma_uint64 frameCount;
-  };
-
-  std::map<std::string, CachedSound> sound_cache;
-
-  struct ActiveVoice {
-    ma_sound sound;
-    ma_audio_buffer buffer;
-    bool active;
-  };
-
-  std::vector<ActiveVoice *> active_voices;
+  // Directory sound file names are resolved against
   std::string exe_dir;
 
 public:
@@ -137,8 +119,7 @@ public:
         canvas_texture(nullptr), canvas_srv(nullptr), vertex_shader(nullptr),
         pixel_shader(nullptr), input_layout(nullptr), vertex_buffer(nullptr),
         constant_buffer(nullptr), sampler_state(nullptr), canvas_bits(nullptr),
-        active_background(nullptr), default_background(nullptr),
-        audio_initialized(false) {
+        active_background(nullptr), default_background(nullptr) {
     // Get executable directory
     char exe_path[MAX_PATH];
     DWORD count = GetModuleFileNameA(NULL, exe_path, MAX_PATH);
@@ -219,16 +200,7 @@ public:
       return false;
 
     // Initialize audio
-    ma_engine_config audio_config = ma_engine_config_init();
-    audio_config.channels = 2;
-    audio_config.sampleRate = 22050;
-
-    if (ma_engine_init(&audio_config, &audio_engine) == MA_SUCCESS) {
-      audio_initialized = true;
-      std::cout << "Audio initialized (D3D11)." << std::endl;
-    } else {
-      std::cerr << "Failed to initialize audio engine." << std::endl;
-    }
+    init_audio(exe_dir.c_str());
 
     ShowWindow(hwnd, SW_SHOW);
     running = true;
@@ -520,20 +492,8 @@ public:
   }
 
   bool process_events() override {
-    // Clean up finished voices
-    if (audio_initialized) {
-      for (auto it = active_voices.begin(); it != active_voices.end();) {
-        ActiveVoice *voice = *it;
-        if (ma_sound_at_end(&voice->sound)) {
-          ma_sound_uninit(&voice->sound);
-          ma_audio_buffer_uninit(&voice->buffer);
-          delete voice;
-          it = active_voices.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    }
+    // Reclaim finished voices, stamp this frame's audio start time
+    update_audio();
 
     MSG msg;
     while (PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE)) {
@@ -564,79 +524,17 @@ public:
     if (!canvas_bits)
       return;
 
-    // Draw foreground drawables (CPU-side, matching GDI logic)
-    for (int i = 0; i < foreground_drawables_count; i++) {
-      ForegroundDrawable &fd = foreground_drawables[i];
-      if (!fd.sprite || !fd.mask)
-        continue;
-
-      if (fd.flags & DRAW_FLAG_HIDDEN)
-        continue;
-
-      int width = fd.sprite->width;
-      int height = fd.sprite->height;
-      int sprite_stride = fd.sprite->width_in_words * 4;
-
-      uint8_t *sprite_bytes = (uint8_t *)fd.sprite->pixels;
-      uint8_t *mask_bytes = (uint8_t *)fd.mask->pixels;
-
-      bool invert = (fd.flags & DRAW_FLAG_INVERT);
-
-      // Determine loop parameters (Ignores interlacing on D3D11)
-      int y_step = 1;
-      int start_y = 0;
-
-      // Draw sprite
-      for (int y = start_y; y < height; y += y_step) {
-        int screen_y = fd.y + y;
-        if (screen_y < 0 || screen_y >= canvas_height)
-          continue;
-
-        for (int byte_col = 0; byte_col < sprite_stride; byte_col++) {
-          int idx = y * sprite_stride + byte_col;
-          uint8_t s_byte = sprite_bytes[idx];
-          uint8_t m_byte = mask_bytes[idx];
-
-          if (m_byte == 0)
-            continue;
-
-          for (int bit = 0; bit < 8; bit++) {
-            int px_offset = byte_col * 8 + bit;
-            if (px_offset >= width)
-              break;
-
-            int screen_x = fd.x + px_offset;
-            if (screen_x < 0 || screen_x >= canvas_width)
-              continue;
-
-            int shift = 7 - bit;
-            bool is_opaque = (m_byte >> shift) & 1;
-            bool is_ink = (s_byte >> shift) & 1;
-
-            if (!is_opaque)
-              continue;
-
-            // Calculate canvas position
-            int canvas_byte = screen_y * canvas_stride + screen_x / 8;
-            int canvas_bit = 7 - (screen_x % 8);
-
-            if (invert) {
-              // XOR the pixel
-              if (is_ink) {
-                canvas_bits[canvas_byte] ^= (1 << canvas_bit);
-              }
-            } else {
-              // Set or clear the pixel
-              if (is_ink) {
-                canvas_bits[canvas_byte] |= (1 << canvas_bit);
-              } else {
-                canvas_bits[canvas_byte] &= ~(1 << canvas_bit);
-              }
-            }
-          }
-        }
-      }
-    }
+    CanvasBuffer canvas;
+    canvas.words = (uint32_t *)canvas_bits;
+    canvas.width = canvas_width;
+    canvas.height = canvas_height;
+    canvas.width_in_words = canvas_width / 32;
+
+    // Ignores interlacing on D3D11
+    canvas.row_step = 1;
+    canvas.row_parity = 0;
+
+    rasterize_lists(&canvas);
   }
 
   void draw_end() override {
@@ -752,94 +650,10 @@ public:
 
   void sleep_ms(int ms) override { Sleep(ms); }
 
-  void play_sound(const char *filename) override {
-    if (!audio_initialized)
-      return;
-
-    load_sound(filename);
-
-    if (sound_cache.find(filename) == sound_cache.end())
-      return;
-
-    CachedSound &cached = sound_cache[filename];
-
-    ActiveVoice *voice = new ActiveVoice();
-    voice->active = true;
-
-    ma_audio_buffer_config config = ma_audio_buffer_config_init(
-        ma_format_f32, 2, cached.frameCount, cached.pData, NULL);
-    ma_result result = ma_audio_buffer_init(&config, &voice->buffer);
-
-    if (result != MA_SUCCESS) {
-      delete voice;
-      return;
-    }
-
-    result = ma_sound_init_from_data_source(&audio_engine, &voice->buffer, 0,
-                                            NULL, &voice->sound);
-    if (result != MA_SUCCESS) {
-      ma_audio_buffer_uninit(&voice->buffer);
-      delete voice;
-      return;
-    }
-
-    ma_sound_start(&voice->sound);
-    active_voices.push_back(voice);
-  }
-
-  void load_sound(const char *filename) override {
-    if (!audio_initialized)
-      return;
-    if (sound_cache.find(filename) != sound_cache.end())
-      return;
-
-    std::string path = exe_dir + "/" + filename;
-
-    ma_decoder_config config = ma_decoder_config_init(
-        ma_format_f32, 2, ma_engine_get_sample_rate(&audio_engine));
-
-    ma_uint64 frameCount;
-    void *pData;
-
-    ma_result result =
-        ma_decode_file(path.c_str(), &config, &frameCount, &pData);
-    if (result != MA_SUCCESS) {
-      std::cout << "Failed to load sound: " << path << std::endl;
-      return;
-    } else {
-      std::cout << "Loaded: " << path << std::endl;
-    }
-
-    CachedSound sound;
-    sound.pData = pData;
-    sound.frameCount = frameCount;
-    sound_cache[filename] = sound;
-  }
-
-  void clear_sounds() override {
-    for (auto *voice : active_voices) {
-      ma_sound_stop(&voice->sound);
-      ma_sound_uninit(&voice->sound);
-      ma_audio_buffer_uninit(&voice->buffer);
-      delete voice;
-    }
-    active_voices.clear();
-
-    for (auto &pair : sound_cache) {
-      ma_free(pair.second.pData, NULL);
-    }
-    sound_cache.clear();
-  }
-
   int get_width() const override { return canvas_width; }
   int get_height() const override { return canvas_height; }
 
   ~EngineD3D11() {
-    clear_sounds();
-    if (audio_initialized) {
-      ma_engine_uninit(&audio_engine);
-    }
-
     if (default_background)
       free(default_background);
 
@@ -3,13 +3,12 @@
 #include <cstring>
 #include <ctime>
 #include <iostream>
-#include <map>
 #include <string>
 #include <vector>
 #include <windows.h>
 
-#include "../vendor/miniaudio.h"
 #include "bkgimage.h"
+#include "blitter.h"
 #include "engine.h"
 #include "sprite.h"
 
@@ -50,24 +49,7 @@ private:
   BkgImage *default_background;
   bool is_even_phase;
 
-  // Audio State
-  ma_engine audio_engine;
-  bool audio_initialized;
-
-  struct CachedSound {
-    void *pData;
-    ma_uint64 frameCount;
-  };
-
-  std::map<std::string, CachedSound> sound_cache;
-
-  struct ActiveVoice {
-    ma_sound sound;
-    ma_audio_buffer buffer;
-    bool active;
-  };
-
-  std::vector<ActiveVoice *> active_voices;
+  // Directory sound file names are resolved against
   std::string exe_dir;
 
 public:
@@ -77,8 +59,7 @@ public:
         back_buffer_bitmap(nullptr), old_canvas_bitmap(nullptr),
         old_back_buffer_bitmap(nullptr), running(false), canvas_bits(nullptr),
         back_buffer_bits(nullptr), active_background(nullptr),
-        default_background(nullptr), is_even_phase(true),
-        audio_initialized(false) {
+        default_background(nullptr), is_even_phase(true) {
     // Get executable directory
     char exe_path[MAX_PATH];
     DWORD count = GetModuleFileNameA(NULL, exe_path, MAX_PATH);
@@ -201,16 +182,7 @@ public:
         (HBITMAP)SelectObject(back_buffer_dc, back_buffer_bitmap);
 
     // Initialize audio
-    ma_engine_config audio_config = ma_engine_config_init();
-    audio_config.channels = 2;
-    audio_config.sampleRate = 22050;
-
-    if (ma_engine_init(&audio_config, &audio_engine) == MA_SUCCESS) {
-      audio_initialized = true;
-      std::cout << "Audio initialized (GDI)." << std::endl;
-    } else {
-      std::cerr << "Failed to initialize audio engine." << std::endl;
-    }
+    init_audio(exe_dir.c_str());
 
     running = true;
     g_engine = this;
@@ -273,20 +245,8 @@ public:
   }
 
   bool process_events() override {
-    // Clean up finished voices
-    if (audio_initialized) {
-      for (auto it = active_voices.begin(); it != active_voices.end();) {
-        ActiveVoice *voice = *it;
-        if (ma_sound_at_end(&voice->sound)) {
-          ma_sound_uninit(&voice->sound);
-          ma_audio_buffer_uninit(&voice->buffer);
-          delete voice;
-          it = active_voices.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    }
+    // Reclaim finished voices, stamp this frame's audio start time
+    update_audio();
 
     MSG msg;
     while (PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE)) {
@@ -334,90 +294,17 @@ public:
     if (!canvas_bits)
       return;
 
-    uint8_t *canvas_bytes = (uint8_t *)canvas_bits;
-    int canvas_stride = (canvas_width + 31) / 32 * 4;
-
-    // Draw foreground drawables
-    for (int i = 0; i < foreground_drawables_count; i++) {
-      ForegroundDrawable &fd = foreground_drawables[i];
-      if (!fd.sprite || !fd.mask)
-        continue;
-
-      if (fd.flags & DRAW_FLAG_HIDDEN)
-        continue;
-
-      int width = fd.sprite->width;
-      int height = fd.sprite->height;
-      int sprite_stride = fd.sprite->width_in_words * 4;
-
-      uint8_t *sprite_bytes = (uint8_t *)fd.sprite->pixels;
-      uint8_t *mask_bytes = (uint8_t *)fd.mask->pixels;
+    CanvasBuffer canvas;
+    canvas.words = (uint32_t *)canvas_bits;
+    canvas.width = canvas_width;
+    canvas.height = canvas_height;
+    canvas.width_in_words = canvas_width / 32;
 
-      bool invert = (fd.flags & DRAW_FLAG_INVERT);
+    // Interlacing: only touch the rows of the current phase
+    canvas.row_step = interlaced_mode ? 2 : 1;
+    canvas.row_parity = is_even_phase ? 0 : 1;
 
-      // Determine loop parameters based on interlacing
-      int y_step = interlaced_mode ? 2 : 1;
-      int start_y = 0;
-
-      if (interlaced_mode) {
-        int desired_parity = is_even_phase ? 0 : 1;
-        int current_parity = (fd.y) & 1;
-        if (current_parity != desired_parity) {
-          start_y = 1;
-        }
-      }
-
-      // Draw sprite
-      for (int y = start_y; y < height; y += y_step) {
-        int screen_y = fd.y + y;
-        if (screen_y < 0 || screen_y >= canvas_height)
-          continue;
-
-        for (int byte_col = 0; byte_col < sprite_stride; byte_col++) {
-          int idx = y * sprite_stride + byte_col;
-          uint8_t s_byte = sprite_bytes[idx];
-          uint8_t m_byte = mask_bytes[idx];
-
-          if (m_byte == 0)
-            continue;
-
-          for (int bit = 0; bit < 8; bit++) {
-            int px_offset = byte_col * 8 + bit;
-            if (px_offset >= width)
-              break;
-
-            int screen_x = fd.x + px_offset;
-            if (screen_x < 0 || screen_x >= canvas_width)
-              continue;
-
-            int shift = 7 - bit;
-            bool is_opaque = (m_byte >> shift) & 1;
-            bool is_ink = (s_byte >> shift) & 1;
-
-            if (!is_opaque)
-              continue;
-
-            // Calculate canvas position
-            int canvas_byte = screen_y * canvas_stride + screen_x / 8;
-            int canvas_bit = 7 - (screen_x % 8);
-
-            if (invert) {
-              // XOR the pixel
-              if (is_ink) {
-                canvas_bytes[canvas_byte] ^= (1 << canvas_bit);
-              }
-            } else {
-              // Set or clear the pixel
-              if (is_ink) {
-                canvas_bytes[canvas_byte] |= (1 << canvas_bit);
-              } else {
-                canvas_bytes[canvas_byte] &= ~(1 << canvas_bit);
-              }
-            }
-          }
-        }
-      }
-    }
+    rasterize_lists(&canvas);
   }
 
   void draw_end() override {
@@ -483,98 +370,10 @@ public:
 
   void sleep_ms(int ms) override { Sleep(ms); }
 
-  void play_sound(const char *filename) override {
-    if (!audio_initialized)
-      return;
-
-    load_sound(filename);
-
-    if (sound_cache.find(filename) == sound_cache.end())
-      return;
-
-    CachedSound &cached = sound_cache[filename];
-
-    ActiveVoice *voice = new ActiveVoice();
-    voice->active = true;
-
-    ma_audio_buffer_config config = ma_audio_buffer_config_init(
-        ma_format_f32, 2, cached.frameCount, cached.pData, NULL);
-    ma_result result = ma_audio_buffer_init(&config, &voice->buffer);
-
-    if (result != MA_SUCCESS) {
-      std::cerr << "Failed to create audio buffer for " << filename
-                << std::endl;
-      delete voice;
-      return;
-    }
-
-    result = ma_sound_init_from_data_source(&audio_engine, &voice->buffer, 0,
-                                            NULL, &voice->sound);
-    if (result != MA_SUCCESS) {
-      std::cerr << "Failed to init sound for " << filename << std::endl;
-      ma_audio_buffer_uninit(&voice->buffer);
-      delete voice;
-      return;
-    }
-
-    ma_sound_start(&voice->sound);
-    active_voices.push_back(voice);
-  }
-
-  void load_sound(const char *filename) override {
-    if (!audio_initialized)
-      return;
-    if (sound_cache.find(filename) != sound_cache.end())
-      return;
-
-    std::string path = exe_dir + "\\" + filename;
-
-    ma_decoder_config config = ma_decoder_config_init(
-        ma_format_f32, 2, ma_engine_get_sample_rate(&audio_engine));
-
-    ma_uint64 frameCount;
-    void *pData;
-
-    ma_result result =
-        ma_decode_file(path.c_str(), &config, &frameCount, &pData);
-    if (result != MA_SUCCESS) {
-      std::cout << "Failed to load sound: " << path << " (Error " << result
-                << ")" << std::endl;
-      return;
-    } else {
-      std::cout << "Loaded: " << path << std::endl;
-    }
-
-    CachedSound sound;
-    sound.pData = pData;
-    sound.frameCount = frameCount;
-    sound_cache[filename] = sound;
-  }
-
-  void clear_sounds() override {
-    for (auto *voice : active_voices) {
-      ma_sound_stop(&voice->sound);
-      ma_sound_uninit(&voice->sound);
-      ma_audio_buffer_uninit(&voice->buffer);
-      delete voice;
-    }
-    active_voices.clear();
-
-    for (auto &pair : sound_cache) {
-      ma_free(pair.second.pData, NULL);
-    }
-    sound_cache.clear();
-  }
-
   int get_width() const override { return canvas_width; }
   int get_height() const override { return canvas_height; }
 
   ~EngineGDI() {
-    clear_sounds();
-    if (audio_initialized) {
-      ma_engine_uninit(&audio_engine);
-    }
-
     if (default_background)
       free(default_background);
 
@@ -0,0 +1,236 @@
+#ifdef PLATFORM_HEADLESS
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <libgen.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "audio.h"
+#include "bkgimage.h"
+#include "blitter.h"
+#include "engine.h"
+
+#include <string>
+
+// Headless implementation of Engine: no window and no sound card, for CI
+// machines and benchmarks. Frames run back to back on a virtual clock that
+// advances HEADLESS_FRAME_MS per frame (the pace run_loop caps the windowed
+// backends at), and the audio of each frame is mixed offline right after
+// it, so two runs of the same build produce the same pixels and the same
+// samples.
+//
+// Environment:
+//   MONOTEST_FRAMES     Frames to run before quitting (default 600)
+//   MONOTEST_AUDIO_OUT  16-bit WAV file the mixed audio is written to
+
+#define HEADLESS_FRAME_MS 16
+#define HEADLESS_DEFAULT_FRAMES 600
+#define HEADLESS_AUDIO_BLOCK 1024 // Frames mixed per render call
+
+class EngineHeadless : public Engine {
+private:
+  bool running;
+  int canvas_width;
+  int canvas_height;
+
+  // Background
+  BkgImage *active_background;
+  BkgImage *default_background;
+
+  // 1bpp software canvas (same layout as BkgImage pixels, 1 = Black)
+  uint32_t *canvas_words;
+  int canvas_stride; // Bytes per canvas row
+
+  // Virtual clock
+  unsigned long frame; // Frames started
+  unsigned long max_frames;
+  unsigned long now_ms;
+  struct timespec wall_start;
+
+  // Offline audio: frames mixed so far, and where they go
+  uint64_t audio_frames;
+  uint32_t sample_rate;
+  ma_encoder encoder;
+  bool encoder_open;
+  float mix_block[HEADLESS_AUDIO_BLOCK * AUDIO_CHANNELS];
+  int16_t wav_block[HEADLESS_AUDIO_BLOCK * AUDIO_CHANNELS];
+
+  // Directory sound file names are resolved against
+  std::string exe_dir;
+
+  // --- Helper: Mix the audio up to the virtual clock ---
+  void render_audio_until(unsigned long time_ms) {
+    uint64_t target = (uint64_t)time_ms * sample_rate / 1000;
+    while (audio_frames < target) {
+      uint32_t count = HEADLESS_AUDIO_BLOCK;
+      if (target - audio_frames < count)
+        count = (uint32_t)(target - audio_frames);
+
+      render_audio(mix_block, count);
+      if (encoder_open) {
+        ma_pcm_f32_to_s16(wav_block, mix_block, count * AUDIO_CHANNELS,
+                          ma_dither_mode_none);
+        ma_encoder_write_pcm_frames(&encoder, wav_block, count, NULL);
+      }
+      audio_frames += count;
+    }
+  }
+
+public:
+  EngineHeadless()
+      : running(false), active_background(nullptr),
+        default_background(nullptr), canvas_words(nullptr), canvas_stride(0),
+        frame(0), max_frames(HEADLESS_DEFAULT_FRAMES), now_ms(0),
+        audio_frames(0), sample_rate(0), encoder_open(false) {
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    char result[PATH_MAX];
+    ssize_t count = readlink("/proc/self/exe", result, PATH_MAX);
+    if (count != -1) {
+      result[count] = '\0';
+      exe_dir = dirname(result);
+    } else {
+      exe_dir = ".";
+    }
+  }
+
+  bool init(int width, int height, int /*scale_factor*/) override {
+    if (width % 32 != 0) {
+      std::cerr << "Error: Canvas width must be a multiple of 32." << std::endl;
+      return false;
+    }
+
+    canvas_width = width;
+    canvas_height = height;
+
+    // Create Default Background (White)
+    int32_t width_in_words = width / 32;
+    size_t total_bytes = width_in_words * 4 * height;
+    default_background = (BkgImage *)malloc(sizeof(BkgImage) + total_bytes);
+    if (!default_background)
+      return false;
+
+    default_background->width = width;
+    default_background->height = height;
+    default_background->width_in_words = width_in_words;
+    default_background->_padding = 0;
+    memset(default_background->pixels, 0x00, total_bytes);
+
+    active_background = default_background;
+
+    canvas_stride = width_in_words * 4;
+    canvas_words = (uint32_t *)malloc(total_bytes);
+    if (!canvas_words)
+      return false;
+    memset(canvas_words, 0x00, total_bytes);
+
+    // Run length and audio capture
+    const char *frames_env = getenv("MONOTEST_FRAMES");
+    if (frames_env && atol(frames_env) > 0)
+      max_frames = (unsigned long)atol(frames_env);
+
+    if (init_audio_offline(exe_dir.c_str())) {
+      sample_rate = AudioSystem_SampleRate(audio);
+      const char *wav_path = getenv("MONOTEST_AUDIO_OUT");
+      if (wav_path && *wav_path) {
+        ma_encoder_config config = ma_encoder_config_init(
+            ma_encoding_format_wav, ma_format_s16, AUDIO_CHANNELS,
+            sample_rate);
+        if (ma_encoder_init_file(wav_path, &config, &encoder) == MA_SUCCESS)
+          encoder_open = true;
+        else
+          std::cerr << "Failed to open audio output: " << wav_path
+                    << std::endl;
+      }
+    }
+
+    running = true;
+    return true;
+  }
+
+  bool process_events() override {
+    // The first frame starts at 0; each later one moves the clock on and
+    // mixes the audio of the frame that just ran
+    if (frame > 0) {
+      now_ms += HEADLESS_FRAME_MS;
+      render_audio_until(now_ms);
+    }
+    if (frame >= max_frames)
+      running = false;
+    if (!running)
+      return false;
+
+    // Reclaim finished voices, stamp this frame's audio start time
+    update_audio();
+    frame++;
+    return true;
+  }
+
+  void draw_start() override {
+    if (!active_background) {
+      memset(canvas_words, 0x00, canvas_stride * canvas_height);
+      return;
+    }
+    memcpy(canvas_words, active_background->pixels,
+           canvas_stride * canvas_height);
+  }
+
+  void draw_lists() override {
+    CanvasBuffer canvas;
+    canvas.words = canvas_words;
+    canvas.width = canvas_width;
+    canvas.height = canvas_height;
+    canvas.width_in_words = canvas_width / 32;
+    canvas.row_step = 1;
+    canvas.row_parity = 0;
+
+    rasterize_lists(&canvas);
+  }
+
+  void draw_end() override {} // Nothing to present
+
+  void set_active_background(BkgImage *bkg) override {
+    if (bkg) {
+      if (bkg->width != canvas_width || bkg->height != canvas_height) {
+        std::cerr << "Error: Active background size mismatch! Expected "
+                  << canvas_width << "x" << canvas_height << ", got "
+                  << bkg->width << "x" << bkg->height << std::endl;
+        return;
+      }
+      active_background = bkg;
+    } else {
+      active_background = default_background;
+    }
+  }
+
+  BkgImage *get_active_background() override { return active_background; }
+
+  bool is_running() override { return running; }
+  // Virtual: the game sees exactly HEADLESS_FRAME_MS pass per frame
+  unsigned long get_time_ms() override { return now_ms; }
+  void sleep_ms(int /*ms*/) override {}
+  int get_width() const override { return canvas_width; }
+  int get_height() const override { return canvas_height; }
+
+  ~EngineHeadless() {
+    struct timespec wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    double elapsed_ms = (wall_end.tv_sec - wall_start.tv_sec) * 1000.0 +
+                        (wall_end.tv_nsec - wall_start.tv_nsec) / 1000000.0;
+    std::cout << "Headless run: " << frame << " frames, " << audio_frames
+              << " audio frames in " << elapsed_ms << " ms" << std::endl;
+
+    if (encoder_open)
+      ma_encoder_uninit(&encoder);
+    if (default_background)
+      free(default_background);
+    if (canvas_words)
+      free(canvas_words);
+  }
+};
+
+Engine *create_engine() { return new EngineHeadless(); }
+
+#endif // PLATFORM_HEADLESS
@@ -12,13 +12,12 @@
 #include <unistd.h>
 #include <vector>
 
+#include "blitter.h"
 #include "engine.h"
 #include "sprite.h"
 
 #include "bkgimage.h"
 
-#include "../vendor/miniaudio.h"
-#include <map>
 #include <string>
 
 // The X11 implementation of Engine will be our reference implementation for
@@ -28,10 +27,8 @@ class EngineX11 : public Engine {
 private:
   Display *display;
   Window window;
-  Pixmap canvas;
   Pixmap back_buffer; // New back buffer
   GC window_gc;
-  GC canvas_gc;
   int screen;
   bool running;
   int window_width;
@@ -43,41 +40,20 @@ private:
   // Background
   BkgImage *active_background;
   BkgImage *default_background;
-  XImage *bg_ximage; // Reusable wrapper for background data
   bool is_even_phase;
-  Pixmap even_mask;
-  Pixmap odd_mask;
 
-  // Pixel buffer for rendering
-  char *image_data;
-  XImage *ximage;
+  // 1bpp software canvas (same layout as BkgImage pixels, 1 = Black)
+  uint32_t *canvas_words;
+  int canvas_stride; // Bytes per canvas row
 
-  // Audio State
-  ma_engine engine;
-  bool audio_initialized;
-
-  struct CachedSound {
-    void *pData;
-    ma_uint64 frameCount;
-  };
-
-  std::map<std::string, CachedSound> sound_cache;
-
-  struct ActiveVoice {
-    ma_sound sound;
-    ma_audio_buffer buffer;
-    bool active;
-  };
-
-  std::vector<ActiveVoice *> active_voices;
+  // Directory sound file names are resolved against
   std::string exe_dir;
 
 public:
   EngineX11()
       : display(nullptr), running(false), active_background(nullptr),
-        default_background(nullptr), bg_ximage(nullptr), is_even_phase(true),
-        even_mask(0), odd_mask(0), image_data(nullptr), ximage(nullptr),
-        audio_initialized(false) {
+        default_background(nullptr), is_even_phase(true),
+        canvas_words(nullptr), canvas_stride(0) {
     char result[PATH_MAX];
     ssize_t count = readlink("/proc/self/exe", result, PATH_MAX);
     if (count != -1) {
@@ -113,6 +89,13 @@ public:
 
     active_background = default_background;
 
+    // Software canvas, persists between frames (needed for interlacing)
+    canvas_stride = width_in_words * 4;
+    canvas_words = (uint32_t *)malloc(total_bytes);
+    if (!canvas_words)
+      return false;
+    memset(canvas_words, 0x00, total_bytes);
+
     display = XOpenDisplay(nullptr);
     if (display == nullptr) {
       std::cerr << "Failed to open X display" << std::endl;
@@ -141,81 +124,15 @@ public:
     back_buffer = XCreatePixmap(display, window, window_width, window_height,
                                 DefaultDepth(display, screen));
 
-    // Create low-res canvas (Pixmap)
-    canvas = XCreatePixmap(display, window, canvas_width, canvas_height,
-                           DefaultDepth(display, screen));
-    canvas_gc = XCreateGC(display, canvas, 0, nullptr);
-
-    // Create reusable XImage for background
-    // We create it once since dimensions are enforced.
-    // depth=1, format=XYBitmap, offset=0, data=NULL (set at draw time)
-    // width, height, bitmap_pad=32, bytes_per_line=0 (auto)
-    bg_ximage =
-        XCreateImage(display, DefaultVisual(display, screen), 1, XYBitmap, 0,
-                     nullptr, canvas_width, canvas_height, 32, 0);
-    if (bg_ximage) {
-      bg_ximage->bitmap_bit_order = MSBFirst; // PBM is MSB first
-      bg_ximage->byte_order = MSBFirst;       // Matches file read
-      bg_ximage->bitmap_bit_order = MSBFirst; // PBM is MSB first
-      bg_ximage->byte_order = MSBFirst;       // Matches file read
-    }
-
-    // Create Interlace Masks (Stencils)
-    // 1-bit depth maps where 1=Draw, 0=Mask
-    even_mask = XCreatePixmap(display, window, canvas_width, canvas_height, 1);
-    odd_mask = XCreatePixmap(display, window, canvas_width, canvas_height, 1);
-
-    GC mask_gc = XCreateGC(display, even_mask, 0, nullptr);
-
-    // EVEN MASK: Rows 0, 2, 4... are 1 (Draw), others 0
-    XSetForeground(display, mask_gc, 0);
-    XFillRectangle(display, even_mask, mask_gc, 0, 0, canvas_width,
-                   canvas_height);
-    XSetForeground(display, mask_gc, 1);
-    for (int y = 0; y < canvas_height; y += 2) {
-      XDrawLine(display, even_mask, mask_gc, 0, y, canvas_width, y);
-    }
-
-    // ODD MASK: Rows 1, 3, 5... are 1 (Draw), others 0
-    XSetForeground(display, mask_gc, 0);
-    XFillRectangle(display, odd_mask, mask_gc, 0, 0, canvas_width,
-                   canvas_height);
-    XSetForeground(display, mask_gc, 1);
-    for (int y = 1; y < canvas_height; y += 2) {
-      XDrawLine(display, odd_mask, mask_gc, 0, y, canvas_width, y);
-    }
-
-    XFreeGC(display, mask_gc);
-    ma_engine_config audio_config = ma_engine_config_init();
-    audio_config.channels = 2;
-    audio_config.sampleRate = 22050; // Retro sample rate
-
-    if (ma_engine_init(&audio_config, &engine) == MA_SUCCESS) {
-      audio_initialized = true;
-      std::cout << "Audio initialized successfully." << std::endl;
-    } else {
-      std::cerr << "Failed to initialize audio engine." << std::endl;
-    }
+    init_audio(exe_dir.c_str());
 
     running = true;
     return true;
   }
 
   bool process_events() override {
-    // Clean up finished voices
-    if (audio_initialized) {
-      for (auto it = active_voices.begin(); it != active_voices.end();) {
-        ActiveVoice *voice = *it;
-        if (ma_sound_at_end(&voice->sound)) {
-          ma_sound_uninit(&voice->sound);
-          ma_audio_buffer_uninit(&voice->buffer);
-          delete voice;
-          it = active_voices.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    }
+    // Reclaim finished voices, stamp this frame's audio start time
+    update_audio();
 
     XEvent event;
     while (XPending(display) > 0) {
@@ -265,153 +182,37 @@ public:
     }
 
     if (!active_background) {
-      XSetForeground(display, canvas_gc, WhitePixel(display, screen));
-      XFillRectangle(display, canvas, canvas_gc, 0, 0, canvas_width,
-                     canvas_height);
+      memset(canvas_words, 0x00, canvas_stride * canvas_height);
       return;
     }
 
-    if (bg_ximage) {
-      // Point data to the active background pixels
-      bg_ximage->data = (char *)active_background->pixels;
-
-      // Set colors for 1->Black, 0->White translation (XYBitmap)
-      XSetForeground(display, canvas_gc, BlackPixel(display, screen));
-      XSetBackground(display, canvas_gc, WhitePixel(display, screen));
-
-      if (interlaced_mode) {
-        // Optimization via Clip Mask
-        XSetClipMask(display, canvas_gc, is_even_phase ? even_mask : odd_mask);
-        XSetClipOrigin(display, canvas_gc, 0, 0);
-
-        // Bulk Transfer using XPutImage (Masked by Server)
-        XPutImage(display, canvas, canvas_gc, bg_ximage, 0, 0, 0, 0,
-                  canvas_width, canvas_height);
-
-        // Clear clip mask for subsequent drawing operations
-        XSetClipMask(display, canvas_gc, None);
-      } else {
-        // Bulk Transfer using XPutImage (Optimization)
-        XPutImage(display, canvas, canvas_gc, bg_ximage, 0, 0, 0, 0,
-                  canvas_width, canvas_height);
-      }
+    uint8_t *src = (uint8_t *)active_background->pixels;
+    uint8_t *dst = (uint8_t *)canvas_words;
 
-      // Unset data to prevent double free or dangling pointers
-      bg_ximage->data = nullptr;
+    if (interlaced_mode) {
+      // Only refresh the rows of the current phase, the others persist
+      int start_y = is_even_phase ? 0 : 1;
+      for (int y = start_y; y < canvas_height; y += 2) {
+        memcpy(dst + y * canvas_stride, src + y * canvas_stride,
+               canvas_stride);
+      }
     } else {
-      // Fallback
-      XSetForeground(display, canvas_gc, WhitePixel(display, screen));
-      XFillRectangle(display, canvas, canvas_gc, 0, 0, canvas_width,
-                     canvas_height);
+      memcpy(dst, src, canvas_stride * canvas_height);
     }
   }
 
   void draw_lists() override {
-    // Draw for all foreground drawables
-    for (int i = 0; i < foreground_drawables_count; i++) {
-      ForegroundDrawable &fd = foreground_drawables[i];
-      if (!fd.sprite || !fd.mask)
-        continue;
-
-      // Handle Hidden Flag
-      if (fd.flags & DRAW_FLAG_HIDDEN)
-        continue;
-
-      int width = fd.sprite->width;
-      int height = fd.sprite->height;
-      int stride_bytes = fd.sprite->width_in_words * 4;
-
-      uint8_t *sprite_bytes = (uint8_t *)fd.sprite->pixels;
-      uint8_t *mask_bytes = (uint8_t *)fd.mask->pixels;
-
-      // Invert Mode: Skip erasure, just invert destination where Ink is present
-      bool invert = (fd.flags & DRAW_FLAG_INVERT);
-
-      // Determine loop parameters based on interlacing
-      int y_step = interlaced_mode ? 2 : 1;
-      int start_y = 0;
-
-      if (interlaced_mode) {
-        // Calculate the first local 'y' that corresponds to a screen 'y'
-        // matching the current phase.
-        // Screen Y = fd.y + y
-        // We want (fd.y + y) % 2 == (is_even_phase ? 0 : 1)
-        int desired_parity = is_even_phase ? 0 : 1;
-        int current_parity = (fd.y) & 1; // parity of fd.y + 0
-
-        if (current_parity != desired_parity) {
-          start_y = 1;
-        }
-      }
-
-      // Pass 1: Draw Erasure (White) - ONLY if not inverting
-      if (!invert) {
-        XSetForeground(display, canvas_gc, WhitePixel(display, screen));
-        for (int y = start_y; y < height; y += y_step) {
-          for (int byte_col = 0; byte_col < stride_bytes; byte_col++) {
-            int idx = y * stride_bytes + byte_col;
-            uint8_t s_byte = sprite_bytes[idx];
-            uint8_t m_byte = mask_bytes[idx];
-
-            if (m_byte == 0)
-              continue;
-
-            for (int bit = 0; bit < 8; bit++) {
-              int px_offset = byte_col * 8 + bit;
-              if (px_offset >= width)
-                break;
-
-              int shift = 7 - bit;
-              bool is_opaque = (m_byte >> shift) & 1;
-              bool is_ink = (s_byte >> shift) & 1;
-
-              if (is_opaque && !is_ink) {
-                XDrawPoint(display, canvas, canvas_gc, fd.x + px_offset,
-                           fd.y + y);
-              }
-            }
-          }
-        }
-      }
+    CanvasBuffer canvas;
+    canvas.words = canvas_words;
+    canvas.width = canvas_width;
+    canvas.height = canvas_height;
+    canvas.width_in_words = canvas_width / 32;
 
-      // Pass 2: Draw Ink (Black or Invert)
-      if (invert) {
-        XSetFunction(display, canvas_gc, GXinvert);
-      } else {
-        XSetForeground(display, canvas_gc, BlackPixel(display, screen));
-      }
-
-      for (int y = start_y; y < height; y += y_step) {
-
-        for (int byte_col = 0; byte_col < stride_bytes; byte_col++) {
-          int idx = y * stride_bytes + byte_col;
-          uint8_t s_byte = sprite_bytes[idx];
-          uint8_t m_byte = mask_bytes[idx];
-
-          if (m_byte == 0)
-            continue;
-
-          for (int bit = 0; bit < 8; bit++) {
-            int px_offset = byte_col * 8 + bit;
-            if (px_offset >= width)
-              break;
-
-            int shift = 7 - bit;
-            bool is_opaque = (m_byte >> shift) & 1;
-            bool is_ink = (s_byte >> shift) & 1;
-
-            if (is_opaque && is_ink) {
-              XDrawPoint(display, canvas, canvas_gc, fd.x + px_offset,
-                         fd.y + y);
-            }
-          }
-        }
-      }
+    // Interlacing: only touch the rows of the current phase
+    canvas.row_step = interlaced_mode ? 2 : 1;
+    canvas.row_parity = is_even_phase ? 0 : 1;
 
-      if (invert) {
-        XSetFunction(display, canvas_gc, GXcopy); // Restore normal mode
-      }
-    }
+    rasterize_lists(&canvas);
   }
 
   void draw_end() override {
@@ -432,10 +233,7 @@ public:
     XFillRectangle(display, back_buffer, window_gc, 0, 0, window_width,
                    window_height);
 
-    XImage *canvas_img = XGetImage(display, canvas, 0, 0, canvas_width,
-                                   canvas_height, AllPlanes, ZPixmap);
-    if (!canvas_img)
-      return;
+    const uint8_t *canvas_bytes = (const uint8_t *)canvas_words;
 
     if (pixel_perfect_mode) {
       int scale_x = window_width / canvas_width;
@@ -459,10 +257,9 @@ public:
 
       for (int y = 0; y < canvas_height; y++) {
         for (int x = 0; x < canvas_width; x++) {
-          unsigned long pixel = XGetPixel(canvas_img, x, y);
           // If the pixel on canvas is Black (Ink), we draw it as 'ink_color' on
           // screen
-          if (pixel == BlackPixel(display, screen)) {
+          if (canvas_bytes[y * canvas_stride + (x >> 3)] & (0x80 >> (x & 7))) {
             XFillRectangle(
                 display, back_buffer, window_gc, offset_x + x * current_scale,
                 offset_y + y * current_scale, current_scale, current_scale);
@@ -488,8 +285,7 @@ public:
           dest_h = 1;
 
         for (int x = 0; x < canvas_width; x++) {
-          unsigned long pixel = XGetPixel(canvas_img, x, y);
-          if (pixel == BlackPixel(display, screen)) {
+          if (canvas_bytes[y * canvas_stride + (x >> 3)] & (0x80 >> (x & 7))) {
             int dest_x = (int)(x * scale_x_f);
             int dest_w = (int)((x + 1) * scale_x_f) - dest_x;
             if (dest_w < 1)
@@ -502,8 +298,6 @@ public:
       }
     }
 
-    XDestroyImage(canvas_img);
-
     // 2. Flip: Copy Back Buffer to Window
     XCopyArea(display, back_buffer, window, window_gc, 0, 0, window_width,
               window_height, 0, 0);
@@ -527,7 +321,6 @@ public:
 
   BkgImage *get_active_background() override { return active_background; }
 
-  // ... (Audio stubs unchanged) ...
   bool is_running() override { return running; }
   unsigned long get_time_ms() override {
     struct timespec ts;
@@ -535,114 +328,16 @@ public:
     return (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
   }
   void sleep_ms(int ms) override { usleep(ms * 1000); }
-  void play_sound(const char *filename) override {
-    if (!audio_initialized)
-      return;
-
-    // Ensure loaded
-    load_sound(filename);
-
-    if (sound_cache.find(filename) == sound_cache.end())
-      return; // Load failed
-
-    CachedSound &cached = sound_cache[filename];
-
-    ActiveVoice *voice = new ActiveVoice();
-    voice->active = true;
-
-    // Re-configure to not copy data
-    ma_audio_buffer_config config = ma_audio_buffer_config_init(
-        ma_format_f32, 2, cached.frameCount, cached.pData, NULL);
-    ma_result result = ma_audio_buffer_init(&config, &voice->buffer);
-
-    if (result != MA_SUCCESS) {
-      std::cerr << "Failed to create audio buffer for " << filename
-                << std::endl;
-      delete voice;
-      return;
-    }
-
-    result = ma_sound_init_from_data_source(&engine, &voice->buffer, 0, NULL,
-                                            &voice->sound);
-    if (result != MA_SUCCESS) {
-      std::cerr << "Failed to init sound for " << filename << std::endl;
-      ma_audio_buffer_uninit(&voice->buffer);
-      delete voice;
-      return;
-    }
-
-    ma_sound_start(&voice->sound);
-    active_voices.push_back(voice);
-  }
-
-  void load_sound(const char *filename) override {
-    if (!audio_initialized)
-      return;
-    if (sound_cache.find(filename) != sound_cache.end())
-      return;
-
-    std::string path = exe_dir + "/" + filename;
-
-    ma_decoder_config config = ma_decoder_config_init(
-        ma_format_f32, 2, ma_engine_get_sample_rate(&engine));
-
-    ma_uint64 frameCount;
-    void *pData;
-
-    ma_result result =
-        ma_decode_file(path.c_str(), &config, &frameCount, &pData);
-    if (result != MA_SUCCESS) {
-      std::cout << "Failed to load sound: " << path << " (Error " << result
-                << ")" << std::endl;
-      return;
-    } else {
-      std::cout << "Loaded sound: " << path << std::endl;
-    }
-
-    CachedSound sound;
-    sound.pData = pData;
-    sound.frameCount = frameCount;
-    sound_cache[filename] = sound;
-  }
-
-  void clear_sounds() override {
-    // Stop all voices
-    for (auto *voice : active_voices) {
-      ma_sound_stop(&voice->sound);
-      ma_sound_uninit(&voice->sound);
-      ma_audio_buffer_uninit(&voice->buffer);
-      delete voice;
-    }
-    active_voices.clear();
-
-    // Free cached data
-    for (auto &pair : sound_cache) {
-      ma_free(pair.second.pData, NULL);
-    }
-    sound_cache.clear();
-  }
   int get_width() const override { return canvas_width; }
   int get_height() const override { return canvas_height; }
 
   ~EngineX11() {
-    clear_sounds();
-    if (audio_initialized) {
-      ma_engine_uninit(&engine);
-    }
+    if (default_background)
+      free(default_background);
+    if (canvas_words)
+      free(canvas_words);
     if (display) {
-      if (default_background)
-        free(default_background);
-      if (even_mask)
-        XFreePixmap(display, even_mask);
-      if (odd_mask)
-        XFreePixmap(display, odd_mask);
-      if (bg_ximage) {
-        bg_ximage->data = nullptr; // Ensure we don't free external data
-        XDestroyImage(bg_ximage);
-      }
       XFreePixmap(display, back_buffer); // Clean up
-      XFreePixmap(display, canvas);
-      XFreeGC(display, canvas_gc);
       XFreeGC(display, window_gc);
       XDestroyWindow(display, window);
       XCloseDisplay(display);
@@ -0,0 +1,70 @@
+#include "font.h"
+#include "blitter.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+int MeasureText(const BitmapFont *font, const char *text, int length) {
+  int width = 0;
+  for (int i = 0; i < length; i++) {
+    width += Font_Advance(font, text[i]);
+  }
+  return width;
+}
+
+Sprite *RenderTextSprite(SpriteArena *arena, const BitmapFont *font,
+                         const char *text) {
+  int length = (int)strlen(text);
+  int width = MeasureText(font, text, length);
+
+  // Round up to whole words; the last glyph may also reach past its advance
+  int last_ink = width + font->glyph_width;
+  int32_t words_per_row = (last_ink + 31) / 32;
+  if (words_per_row < 1)
+    words_per_row = 1;
+
+  size_t total_data_bytes = (size_t)words_per_row * 4 * font->glyph_height;
+  Sprite *s =
+      (Sprite *)Arena_Alloc(arena, sizeof(Sprite) + total_data_bytes, 4);
+  if (!s)
+    return nullptr;
+
+  s->width = (int16_t)(words_per_row * 32);
+  s->height = font->glyph_height;
+  s->width_in_words = words_per_row;
+  s->flags = 0;
+  memset(s->pixels, 0, total_data_bytes);
+
+  CanvasBuffer target;
+  target.words = s->pixels;
+  target.width = s->width;
+  target.height = s->height;
+  target.width_in_words = words_per_row;
+  target.row_step = 1;
+  target.row_parity = 0;
+
+  BlitText(&target, font, 0, 0, text, length, 0);
+  return s;
+}
+
+Sprite *GetStaticTextSprite(SpriteRegistry *registry, SpriteArena *arena,
+                            const BitmapFont *font, const char *text) {
+  // Key on the font as well, the same label may exist in several fonts
+  char key[256];
+  int key_length = snprintf(key, sizeof(key), "#text:%p:%s", (const void *)font,
+                            text);
+  if (key_length < 0 || key_length >= (int)sizeof(key)) {
+    std::cerr << "Error: Static text too long to cache: " << text << std::endl;
+    return nullptr;
+  }
+
+  Sprite *cached = AssetRegistry_Find(registry, key);
+  if (cached)
+    return cached;
+
+  Sprite *s = RenderTextSprite(arena, font, text);
+  if (s)
+    AssetRegistry_Add(registry, key, s);
+  return s;
+}
@@ -0,0 +1,72 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include "sprite.h"
+#include "spritearena.h"
+#include "spriteregistry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Printable ASCII (' ' to '~' plus DEL), laid out 16 glyphs per atlas row.
+#define FONT_FIRST_CHAR 32
+#define FONT_MAX_GLYPHS 96
+#define FONT_ATLAS_COLUMNS 16
+
+// A 1bpp bitmap font, repacked from a PBM atlas at load time.
+// Every glyph row is one pixel word (left-most pixel in bit 31, native byte
+// order), so drawing a glyph row is a shift and an OR into at most two
+// canvas words. Glyphs are therefore at most 32 pixels wide.
+typedef struct __attribute__((aligned(4))) BitmapFont {
+  int16_t glyph_width;  // Cell width in the atlas (<= 32)
+  int16_t glyph_height; // Cell height, also used as the line height
+  int16_t glyph_count;  // Glyphs present, starting at FONT_FIRST_CHAR
+  int16_t _padding;
+
+  // Horizontal pen advance per glyph (proportional metrics)
+  uint8_t advance[FONT_MAX_GLYPHS];
+
+  // Flexible Array Member: glyph_count * glyph_height pixel words
+  uint32_t glyph_rows[];
+} BitmapFont;
+
+// A string queued for drawing this frame (see Engine::queue_text).
+// 'text' is not null-terminated; it points into the engine's text pool.
+typedef struct {
+  const BitmapFont *font;
+  const char *text;
+  uint32_t flags; // DRAW_FLAG_INVERT to XOR instead of painting
+  int16_t x;
+  int16_t y;
+  int32_t length;
+} TextRun;
+
+// Returns the glyph rows for 'c', or nullptr if the font has no such glyph.
+static inline const uint32_t *Font_GlyphRows(const BitmapFont *font, char c) {
+  int index = (unsigned char)c - FONT_FIRST_CHAR;
+  if (index < 0 || index >= font->glyph_count)
+    return nullptr;
+  return font->glyph_rows + index * font->glyph_height;
+}
+
+// Pen advance for 'c'. Unknown characters advance by a full cell.
+static inline int Font_Advance(const BitmapFont *font, char c) {
+  int index = (unsigned char)c - FONT_FIRST_CHAR;
+  if (index < 0 || index >= font->glyph_count)
+    return font->glyph_width;
+  return font->advance[index];
+}
+
+// Width in pixels of the first 'length' characters of 'text'.
+int MeasureText(const BitmapFont *font, const char *text, int length);
+
+// Renders 'text' once into a new sprite allocated from the arena. Only the
+// glyph ink is set, so the sprite doubles as its own mask.
+Sprite *RenderTextSprite(SpriteArena *arena, const BitmapFont *font,
+                         const char *text);
+
+// Static strings (labels, menu entries) are rendered on first use and then
+// served from the sprite table, so they draw like any other sprite.
+Sprite *GetStaticTextSprite(SpriteRegistry *registry, SpriteArena *arena,
+                            const BitmapFont *font, const char *text);
+
+#endif // FONT_H
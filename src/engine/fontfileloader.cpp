@@ -0,0 +1,115 @@
+#include "fontfileloader.h"
+#include "pixelword.h"
+#include "pbm.h"
+#include "spritefileloader.h"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+// --- Helper: Read 'width' pixels of an atlas row starting at 'x' ---
+// Returns a pixel word with the left-most pixel in bit 31.
+static uint32_t ReadAtlasBits(const Sprite *atlas, int x, int y, int width) {
+  const uint32_t *row = atlas->pixels + y * atlas->width_in_words;
+  int word = x >> 5;
+  int shift = x & 31;
+
+  uint32_t bits = LoadPixelWord(row + word) << shift;
+  if (shift != 0 && word + 1 < atlas->width_in_words)
+    bits |= LoadPixelWord(row + word + 1) >> (32 - shift);
+
+  return width < 32 ? bits & ~(0xFFFFFFFFu >> width) : bits;
+}
+
+BitmapFont *LoadFontPBM(SpriteArena *arena, const char *filename,
+                        int glyph_width, int glyph_height, int fixed_advance) {
+  if (glyph_width <= 0 || glyph_width > 32 || glyph_height <= 0) {
+    std::cerr << "Error: Font " << filename << " glyph size " << glyph_width
+              << "x" << glyph_height << " is not supported (max width 32)."
+              << std::endl;
+    return nullptr;
+  }
+
+  // 1. Load the atlas into a scratch arena. Only the repacked glyphs are kept
+  // in the caller's arena.
+  std::ifstream fs(filename, std::ios::binary | std::ios::ate);
+  if (!fs) {
+    std::cerr << "Error: Could not open file " << filename << std::endl;
+    return nullptr;
+  }
+  size_t file_size = (size_t)fs.tellg();
+  fs.close();
+
+  SpriteArena scratch;
+  size_t capacity = sizeof(Sprite) + PBM_MaxPixelBytes(file_size) + 4;
+  if (!Arena_Init(&scratch, "Scratch arena", capacity, ARENA_BACKING_HEAP))
+    return nullptr;
+
+  Sprite *atlas = LoadSpritePBM(&scratch, filename);
+  if (!atlas) {
+    Arena_Release(&scratch);
+    return nullptr;
+  }
+
+  // 2. Count the cells the atlas actually holds
+  int rows = atlas->height / glyph_height;
+  int columns = atlas->width / glyph_width;
+  if (columns > FONT_ATLAS_COLUMNS)
+    columns = FONT_ATLAS_COLUMNS;
+
+  int glyph_count = (columns < FONT_ATLAS_COLUMNS) ? 0 : rows * columns;
+  if (glyph_count > FONT_MAX_GLYPHS)
+    glyph_count = FONT_MAX_GLYPHS;
+
+  if (glyph_count == 0) {
+    std::cerr << "Error: Font atlas " << filename << " is too small for "
+              << FONT_ATLAS_COLUMNS << " columns of " << glyph_width << "x"
+              << glyph_height << " glyphs." << std::endl;
+    Arena_Release(&scratch);
+    return nullptr;
+  }
+
+  // 3. Allocate the BitmapFont
+  size_t glyph_bytes = (size_t)glyph_count * glyph_height * sizeof(uint32_t);
+  BitmapFont *font =
+      (BitmapFont *)Arena_Alloc(arena, sizeof(BitmapFont) + glyph_bytes, 4);
+  if (!font) {
+    Arena_Release(&scratch);
+    return nullptr;
+  }
+
+  font->glyph_width = (int16_t)glyph_width;
+  font->glyph_height = (int16_t)glyph_height;
+  font->glyph_count = (int16_t)glyph_count;
+  font->_padding = 0;
+
+  // 4. Repack each cell into one pixel word per row and measure its ink
+  for (int g = 0; g < glyph_count; g++) {
+    int cell_x = (g % FONT_ATLAS_COLUMNS) * glyph_width;
+    int cell_y = (g / FONT_ATLAS_COLUMNS) * glyph_height;
+
+    uint32_t ink_columns = 0;
+    uint32_t *dst = font->glyph_rows + g * glyph_height;
+    for (int y = 0; y < glyph_height; y++) {
+      dst[y] = ReadAtlasBits(atlas, cell_x, cell_y + y, glyph_width);
+      ink_columns |= dst[y];
+    }
+
+    int advance;
+    if (fixed_advance > 0) {
+      advance = fixed_advance;
+    } else if (ink_columns == 0) {
+      advance = (glyph_width + 1) / 2; // Blank cell (e.g. space)
+    } else {
+      int last_ink_column = 31 - __builtin_ctz(ink_columns);
+      advance = last_ink_column + 2; // One pixel of spacing
+    }
+    font->advance[g] = (uint8_t)(advance > 255 ? 255 : advance);
+  }
+
+  for (int g = glyph_count; g < FONT_MAX_GLYPHS; g++)
+    font->advance[g] = 0;
+
+  Arena_Release(&scratch);
+  return font;
+}
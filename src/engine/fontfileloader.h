@@ -0,0 +1,16 @@
+#ifndef FONTFILELOADER_H
+#define FONTFILELOADER_H
+
+#include "font.h"
+#include "spritearena.h"
+
+// Loads a font atlas PBM (P4) into a new BitmapFont allocated from the provided
+// arena. The atlas is a grid of glyph_width x glyph_height cells,
+// FONT_ATLAS_COLUMNS per row, starting at FONT_FIRST_CHAR.
+// Glyph advances are measured from the ink in each cell, plus one pixel of
+// spacing. Pass a non-zero fixed_advance for a monospaced font instead.
+// Returns nullptr on failure (file not found, format error, out of memory).
+BitmapFont *LoadFontPBM(SpriteArena *arena, const char *filename,
+                        int glyph_width, int glyph_height, int fixed_advance);
+
+#endif // FONTFILELOADER_H
@@ -0,0 +1,415 @@
+#include "hotreload.h"
+#include "bkgimagefileloader.h"
+#include "engine.h"
+#include "pbm.h"
+#include "scripting.h"
+#include "shiftcache.h"
+#include "spritefileloader.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// --- Helper: Compare paths regardless of a leading "./" ---
+static const char *NormalizePath(const char *path) {
+  while (path[0] == '.' && path[1] == '/')
+    path += 2;
+  return path;
+}
+
+static bool SamePath(const char *a, const char *b) {
+  return strcmp(NormalizePath(a), NormalizePath(b)) == 0;
+}
+
+static bool InRange(const void *ptr, const void *begin, const void *end) {
+  return (const uint8_t *)ptr >= (const uint8_t *)begin &&
+         (const uint8_t *)ptr < (const uint8_t *)end;
+}
+
+void HotReload_Track(HotReload *hr, const char *path, uint32_t type,
+                     void *asset) {
+  if (hr->inotify_fd < 0 || !path)
+    return;
+
+  if (strlen(path) >= HOT_RELOAD_PATH_MAX) {
+    std::cerr << "Warning: Path too long for hot reload: " << path
+              << std::endl;
+    return;
+  }
+
+  HotReloadAsset *entry = nullptr;
+  for (int i = 0; i < hr->asset_count; i++) {
+    if (hr->assets[i].type == type && SamePath(hr->assets[i].path, path)) {
+      entry = &hr->assets[i];
+      break;
+    }
+  }
+
+  if (!entry) {
+    if (hr->asset_count >= HOT_RELOAD_MAX_ASSETS) {
+      std::cerr << "Warning: Hot reload asset limit reached, not tracking "
+                << path << std::endl;
+      return;
+    }
+    entry = &hr->assets[hr->asset_count++];
+    strcpy(entry->path, path);
+    entry->type = type;
+  }
+  entry->asset = asset;
+}
+
+void HotReload_UntrackInRange(HotReload *hr, const void *begin,
+                              const void *end) {
+  int i = 0;
+  while (i < hr->asset_count) {
+    if (hr->assets[i].asset && InRange(hr->assets[i].asset, begin, end)) {
+      hr->assets[i] = hr->assets[--hr->asset_count]; // swap-and-pop
+    } else {
+      i++;
+    }
+  }
+}
+
+#ifdef __linux__
+
+// --- Helper: Watch a directory and everything below it ---
+static void WatchTree(HotReload *hr, const char *dir) {
+  if (hr->watch_count >= HOT_RELOAD_MAX_WATCHES) {
+    std::cerr << "Warning: Hot reload watch limit reached at " << dir
+              << std::endl;
+    return;
+  }
+  if (strlen(dir) >= HOT_RELOAD_PATH_MAX)
+    return;
+
+  int wd = inotify_add_watch(hr->inotify_fd, dir,
+                             IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  if (wd < 0)
+    return;
+
+  HotReloadWatch *watch = &hr->watches[hr->watch_count++];
+  watch->watch_descriptor = wd;
+  strcpy(watch->path, dir);
+
+  DIR *handle = opendir(dir);
+  if (!handle)
+    return;
+
+  struct dirent *ent;
+  while ((ent = readdir(handle)) != nullptr) {
+    if (ent->d_name[0] == '.')
+      continue;
+
+    char child[HOT_RELOAD_PATH_MAX];
+    int length = snprintf(child, sizeof(child), "%s/%s", dir, ent->d_name);
+    if (length < 0 || length >= (int)sizeof(child))
+      continue;
+
+    struct stat st;
+    if (stat(child, &st) == 0 && S_ISDIR(st.st_mode))
+      WatchTree(hr, child);
+  }
+  closedir(handle);
+}
+
+static const char *WatchPath(HotReload *hr, int wd) {
+  for (int i = 0; i < hr->watch_count; i++) {
+    if (hr->watches[i].watch_descriptor == wd)
+      return hr->watches[i].path;
+  }
+  return nullptr;
+}
+
+static void QueueChange(HotReload *hr, const char *path) {
+  for (int i = 0; i < hr->change_count; i++) {
+    if (strcmp(hr->changes[i], path) == 0)
+      return; // Already in this batch
+  }
+  if (hr->change_count >= HOT_RELOAD_MAX_CHANGES) {
+    std::cerr << "Warning: Too many changes for one hot reload batch, "
+              << "ignoring " << path << std::endl;
+    return;
+  }
+  strcpy(hr->changes[hr->change_count++], path);
+}
+
+// --- Helper: Parse a changed file outside the asset arenas ---
+// A failed or rejected reload must not leave garbage in the level's arena,
+// and the loader threads may be allocating from it right now.
+static bool InitScratch(Arena *scratch, const char *path) {
+  struct stat st;
+  if (stat(path, &st) != 0)
+    return false;
+
+  // Sprite, attached mask and span table (at most twice the pixels)
+  size_t capacity = PBM_MaxPixelBytes((size_t)st.st_size) * 4 + 4096;
+  return Arena_Init(scratch, "HotReloadScratch", capacity,
+                    ARENA_BACKING_HEAP);
+}
+
+static size_t BkgImageBytes(const BkgImage *b) {
+  return sizeof(BkgImage) + (size_t)b->height * b->width_in_words * 4;
+}
+
+static bool ReloadSprite(HotReload *hr, HotReloadAsset *entry,
+                         Engine *engine) {
+  Sprite *old_sprite = (Sprite *)entry->asset;
+
+  Arena scratch;
+  if (!InitScratch(&scratch, entry->path))
+    return false;
+
+  // 1. Parse it the same way it was loaded the first time
+  Sprite *fresh;
+  uint32_t mode = (old_sprite->flags & SPRITE_FLAG_MASK_OUTLINE)
+                      ? SPRITE_MASK_OUTLINE
+                      : SPRITE_MASK_SILHOUETTE;
+  if (old_sprite->flags & SPRITE_FLAG_INTERLEAVED) {
+    fresh = LoadInterleavedSpritePBM(&scratch, entry->path, mode);
+  } else if (old_sprite->flags & SPRITE_FLAG_MASKED) {
+    fresh = LoadMaskedSpritePBM(&scratch, entry->path, mode);
+  } else if (old_sprite->flags & SPRITE_FLAG_SPANS) {
+    fresh = LoadSpritePBMWithSpans(&scratch, entry->path);
+  } else {
+    fresh = LoadSpritePBM(&scratch, entry->path);
+  }
+  if (!fresh) {
+    Arena_Release(&scratch);
+    return false;
+  }
+
+  size_t bytes = Sprite_TotalBytes(fresh);
+  if (fresh->width == old_sprite->width &&
+      fresh->height == old_sprite->height &&
+      fresh->flags == old_sprite->flags) {
+    // 2a. Same shape: patch the pixels in place, every pointer stays valid
+    memcpy(old_sprite->pixels, fresh->pixels, bytes - sizeof(Sprite));
+  } else {
+    // 2b. New shape: copy into the arena and re-point everything at it.
+    // The old copy is reclaimed when its level ends.
+    Sprite *copy = (Sprite *)Arena_Alloc(hr->sprite_arena, bytes, 4);
+    if (!copy) {
+      Arena_Release(&scratch);
+      return false;
+    }
+    memcpy(copy, fresh, bytes);
+
+    AssetRegistry_ReplaceAsset(hr->sprite_registry, old_sprite, copy);
+    engine->replace_sprite(old_sprite, copy);
+    if (copy->flags & SPRITE_FLAG_MASKED)
+      engine->replace_sprite(Sprite_Mask(old_sprite), Sprite_Mask(copy));
+    entry->asset = copy;
+  }
+
+  // 3. Pre-shifted variants of the old pixels are stale either way
+  if (engine->shift_cache)
+    ShiftCache_Clear(engine->shift_cache);
+
+  Arena_Release(&scratch);
+  return true;
+}
+
+static bool ReloadBkgImage(HotReload *hr, HotReloadAsset *entry,
+                           Engine *engine) {
+  BkgImage *old_bkg = (BkgImage *)entry->asset;
+
+  Arena scratch;
+  if (!InitScratch(&scratch, entry->path))
+    return false;
+
+  BkgImage *fresh = LoadBkgImagePBM(&scratch, entry->path);
+  if (!fresh) {
+    Arena_Release(&scratch);
+    return false;
+  }
+
+  size_t bytes = BkgImageBytes(fresh);
+  if (fresh->width == old_bkg->width && fresh->height == old_bkg->height) {
+    memcpy(old_bkg->pixels, fresh->pixels, bytes - sizeof(BkgImage));
+  } else {
+    BkgImage *copy = (BkgImage *)Arena_Alloc(hr->bkg_arena, bytes, 16);
+    if (!copy) {
+      Arena_Release(&scratch);
+      return false;
+    }
+    memcpy(copy, fresh, bytes);
+
+    AssetRegistry_ReplaceAsset(hr->bkg_registry, old_bkg, copy);
+    if (engine->get_active_background() == old_bkg)
+      engine->set_active_background(copy);
+    entry->asset = copy;
+  }
+
+  Arena_Release(&scratch);
+  return true;
+}
+
+// --- Helper: Reload whatever was loaded from 'path' ---
+static int ApplyChange(HotReload *hr, const char *path, Engine *engine,
+                       ScriptManager *scripting) {
+  int reloaded = 0;
+
+  // A paired "<name>.mask.pbm" belongs to the sprite "<name>.pbm"
+  char sprite_path[HOT_RELOAD_PATH_MAX];
+  size_t length = strlen(path);
+  if (length > 9 && strcmp(path + length - 9, ".mask.pbm") == 0) {
+    snprintf(sprite_path, sizeof(sprite_path), "%.*s.pbm", (int)(length - 9),
+             path);
+    path = sprite_path;
+  }
+
+  for (int i = 0; i < hr->asset_count; i++) {
+    HotReloadAsset *entry = &hr->assets[i];
+    if (!SamePath(entry->path, path))
+      continue;
+
+    bool ok = false;
+    switch (entry->type) {
+    case HOT_RELOAD_SPRITE:
+      ok = ReloadSprite(hr, entry, engine);
+      break;
+    case HOT_RELOAD_BKGIMAGE:
+      ok = ReloadBkgImage(hr, entry, engine);
+      break;
+    case HOT_RELOAD_SOUND:
+      ok = engine->reload_sound(entry->path);
+      break;
+    }
+
+    if (ok) {
+      std::cout << "Hot reloaded " << entry->path << std::endl;
+      reloaded++;
+    } else {
+      std::cerr << "Error: Hot reload of " << entry->path
+                << " failed, keeping the old version" << std::endl;
+    }
+  }
+
+  // Lua chunks are not arena assets; flag the script that owns them
+  if (scripting && !scripting->get_current_script().empty() &&
+      SamePath(scripting->get_current_script().c_str(), path)) {
+    scripting->reload();
+    reloaded++;
+  }
+
+  return reloaded;
+}
+
+bool HotReload_Init(HotReload *hr, const char *root, SpriteArena *sprite_arena,
+                    BkgImageArena *bkg_arena, SpriteRegistry *sprite_registry,
+                    BkgImageRegistry *bkg_registry) {
+  memset(hr, 0, sizeof(HotReload));
+  hr->sprite_arena = sprite_arena;
+  hr->bkg_arena = bkg_arena;
+  hr->sprite_registry = sprite_registry;
+  hr->bkg_registry = bkg_registry;
+
+  hr->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (hr->inotify_fd < 0) {
+    std::cerr << "Warning: inotify unavailable, hot reload disabled"
+              << std::endl;
+    return false;
+  }
+
+  WatchTree(hr, root);
+  if (hr->watch_count == 0) {
+    HotReload_Shutdown(hr);
+    return false;
+  }
+
+  std::cout << "Hot reload watching " << hr->watch_count
+            << " directories below " << root << std::endl;
+  return true;
+}
+
+void HotReload_Shutdown(HotReload *hr) {
+  if (hr->inotify_fd >= 0)
+    close(hr->inotify_fd); // Also removes every watch
+  hr->inotify_fd = -1;
+  hr->watch_count = 0;
+  hr->asset_count = 0;
+  hr->change_count = 0;
+}
+
+int HotReload_Update(HotReload *hr, unsigned long now_ms, Engine *engine,
+                     ScriptManager *scripting) {
+  if (hr->inotify_fd < 0)
+    return 0;
+
+  // 1. Drain the events that arrived since the last frame
+  char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  while (true) {
+    ssize_t length = read(hr->inotify_fd, buffer, sizeof(buffer));
+    if (length <= 0)
+      break; // EAGAIN: nothing left
+
+    for (char *p = buffer; p < buffer + length;) {
+      const struct inotify_event *event = (const struct inotify_event *)p;
+      p += sizeof(struct inotify_event) + event->len;
+
+      const char *dir = WatchPath(hr, event->wd);
+      if (!dir || event->len == 0 || event->name[0] == '.')
+        continue;
+
+      char path[HOT_RELOAD_PATH_MAX];
+      int n = snprintf(path, sizeof(path), "%s/%s", dir, event->name);
+      if (n < 0 || n >= (int)sizeof(path))
+        continue;
+
+      if (event->mask & IN_ISDIR) {
+        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+          WatchTree(hr, path); // New subdirectory
+        continue;
+      }
+      if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+        QueueChange(hr, path);
+        hr->last_event_ms = now_ms;
+      }
+    }
+  }
+
+  // 2. Apply the batch once writers have gone quiet
+  if (hr->change_count == 0 ||
+      now_ms - hr->last_event_ms < HOT_RELOAD_SETTLE_MS)
+    return 0;
+
+  int reloaded = 0;
+  for (int i = 0; i < hr->change_count; i++)
+    reloaded += ApplyChange(hr, hr->changes[i], engine, scripting);
+  hr->change_count = 0;
+  return reloaded;
+}
+
+#else // No inotify: hot reload stays inactive
+
+bool HotReload_Init(HotReload *hr, const char *root, SpriteArena *sprite_arena,
+                    BkgImageArena *bkg_arena, SpriteRegistry *sprite_registry,
+                    BkgImageRegistry *bkg_registry) {
+  (void)root;
+  memset(hr, 0, sizeof(HotReload));
+  hr->inotify_fd = -1;
+  hr->sprite_arena = sprite_arena;
+  hr->bkg_arena = bkg_arena;
+  hr->sprite_registry = sprite_registry;
+  hr->bkg_registry = bkg_registry;
+  return false;
+}
+
+void HotReload_Shutdown(HotReload *hr) { hr->inotify_fd = -1; }
+
+int HotReload_Update(HotReload *hr, unsigned long now_ms, Engine *engine,
+                     ScriptManager *scripting) {
+  (void)hr;
+  (void)now_ms;
+  (void)engine;
+  (void)scripting;
+  return 0;
+}
+
+#endif
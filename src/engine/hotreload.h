@@ -0,0 +1,94 @@
+#ifndef HOTRELOAD_H
+#define HOTRELOAD_H
+
+#include "bkgimagearena.h"
+#include "bkgimageregistry.h"
+#include "spritearena.h"
+#include "spriteregistry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+class Engine;        // Forward declaration
+class ScriptManager; // Forward declaration
+
+// Development hot reload (Linux only, inotify).
+// Watches every directory below the asset root. Change events are collected
+// without blocking and applied as one batch at a frame boundary, once the
+// files have been quiet for HOT_RELOAD_SETTLE_MS (editors and 'cp' write in
+// several steps).
+//
+// Assets are patched through the pointers the game already holds: when the
+// new file has the same dimensions its pixels are copied over the old ones,
+// otherwise a new copy is made in the arena and every registry entry and
+// drawable is re-pointed at it. Sounds are dropped from the engine cache and
+// decoded again; a changed script is flagged for the game, which restarts
+// the level with it (see ScriptManager::reload).
+//
+// Only files loaded through a tracked path are reloaded. Assets that come
+// from the asset pack are baked; rebuild it with 'make pack' instead.
+
+#define HOT_RELOAD_MAX_WATCHES 64
+#define HOT_RELOAD_MAX_ASSETS 256
+#define HOT_RELOAD_MAX_CHANGES 32
+#define HOT_RELOAD_PATH_MAX 128
+#define HOT_RELOAD_SETTLE_MS 100
+
+#define HOT_RELOAD_SPRITE 1
+#define HOT_RELOAD_BKGIMAGE 2
+#define HOT_RELOAD_SOUND 3
+
+typedef struct {
+  int watch_descriptor;
+  char path[HOT_RELOAD_PATH_MAX]; // Directory, no trailing slash
+} HotReloadWatch;
+
+typedef struct {
+  char path[HOT_RELOAD_PATH_MAX]; // As passed to the loader
+  uint32_t type;                  // HOT_RELOAD_*
+  void *asset;                    // Sprite* or BkgImage*; nullptr for sounds
+} HotReloadAsset;
+
+typedef struct HotReload {
+  int inotify_fd; // -1 when inactive
+  HotReloadWatch watches[HOT_RELOAD_MAX_WATCHES];
+  int watch_count;
+
+  HotReloadAsset assets[HOT_RELOAD_MAX_ASSETS];
+  int asset_count;
+
+  // Changed files, deduplicated, waiting for the batch to settle
+  char changes[HOT_RELOAD_MAX_CHANGES][HOT_RELOAD_PATH_MAX];
+  int change_count;
+  unsigned long last_event_ms;
+
+  // Destinations
+  SpriteArena *sprite_arena;
+  BkgImageArena *bkg_arena;
+  SpriteRegistry *sprite_registry;
+  BkgImageRegistry *bkg_registry;
+} HotReload;
+
+// Starts watching 'root' and everything below it. Returns false (and leaves
+// hot reload inactive) if the platform has no inotify or 'root' is missing.
+bool HotReload_Init(HotReload *hr, const char *root, SpriteArena *sprite_arena,
+                    BkgImageArena *bkg_arena, SpriteRegistry *sprite_registry,
+                    BkgImageRegistry *bkg_registry);
+void HotReload_Shutdown(HotReload *hr);
+
+// Remembers which file an asset came from. Tracking the same path again
+// updates the entry. A no-op while hot reload is inactive.
+void HotReload_Track(HotReload *hr, const char *path, uint32_t type,
+                     void *asset);
+
+// Forgets assets in [begin, end), e.g. the part of an arena a rewind is
+// about to free.
+void HotReload_UntrackInRange(HotReload *hr, const void *begin,
+                              const void *end);
+
+// Drains pending change events and, once the batch has settled, reloads the
+// affected assets. Call once per frame on the main thread. Returns the
+// number of files reloaded.
+int HotReload_Update(HotReload *hr, unsigned long now_ms, Engine *engine,
+                     ScriptManager *scripting);
+
+#endif // HOTRELOAD_H
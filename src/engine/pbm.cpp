@@ -0,0 +1,187 @@
+#include "pbm.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Sprite dimensions are stored as int16_t
+#define PBM_MAX_DIMENSION 32767
+
+static inline bool IsSpace(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+// --- Helper: Skip whitespace and '#' comments ---
+static void SkipSpaceAndComments(PBMFile *file) {
+  while (file->cursor < file->size) {
+    uint8_t c = file->data[file->cursor];
+    if (IsSpace(c)) {
+      file->cursor++;
+    } else if (c == '#') {
+      while (file->cursor < file->size && file->data[file->cursor] != '\n')
+        file->cursor++;
+    } else {
+      break;
+    }
+  }
+}
+
+// --- Helper: Parse a positive decimal header field ---
+static bool ReadDimension(PBMFile *file, int32_t *out) {
+  SkipSpaceAndComments(file);
+
+  int32_t value = 0;
+  size_t start = file->cursor;
+  while (file->cursor < file->size && file->data[file->cursor] >= '0' &&
+         file->data[file->cursor] <= '9') {
+    value = value * 10 + (file->data[file->cursor] - '0');
+    if (value > PBM_MAX_DIMENSION)
+      return false;
+    file->cursor++;
+  }
+
+  *out = value;
+  return file->cursor > start && value > 0;
+}
+
+bool PBM_Open(PBMFile *file, const char *filename) {
+  memset(file, 0, sizeof(*file));
+  file->filename = filename;
+
+  FILE *fp = fopen(filename, "rb");
+  if (!fp) {
+    std::cerr << "Error: Could not open file " << filename << std::endl;
+    return false;
+  }
+
+  // 1. One allocation and one read for the whole file
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  if (size > 0) {
+    file->data = (uint8_t *)malloc((size_t)size);
+    if (file->data)
+      file->size = fread(file->data, 1, (size_t)size, fp);
+  }
+  fclose(fp);
+
+  if (!file->data || file->size != (size_t)size) {
+    std::cerr << "Error: Could not read file " << filename << std::endl;
+    PBM_Close(file);
+    return false;
+  }
+  return true;
+}
+
+void PBM_Close(PBMFile *file) {
+  free(file->data);
+  file->data = nullptr;
+  file->size = 0;
+  file->cursor = 0;
+}
+
+bool PBM_HasImage(PBMFile *file) {
+  while (file->cursor < file->size && IsSpace(file->data[file->cursor]))
+    file->cursor++;
+  return file->cursor < file->size;
+}
+
+bool PBM_ReadHeader(PBMFile *file, PBMImage *image) {
+  // 1. Magic number: "P4" (binary) or "P1" (ASCII)
+  PBM_HasImage(file);
+  if (file->cursor + 2 > file->size || file->data[file->cursor] != 'P' ||
+      (file->data[file->cursor + 1] != '4' &&
+       file->data[file->cursor + 1] != '1')) {
+    std::cerr << "Error: Invalid PBM format in " << file->filename
+              << " (Expected P4 or P1)" << std::endl;
+    return false;
+  }
+  image->format = (char)file->data[file->cursor + 1];
+  file->cursor += 2;
+
+  // 2. Dimensions
+  if (!ReadDimension(file, &image->width) ||
+      !ReadDimension(file, &image->height)) {
+    std::cerr << "Error: Invalid PBM dimensions in " << file->filename
+              << std::endl;
+    return false;
+  }
+  image->width_in_words = (image->width + 31) / 32;
+
+  // 3. Exactly one whitespace byte separates the header from the raster
+  if (file->cursor < file->size && IsSpace(file->data[file->cursor]))
+    file->cursor++;
+
+  return true;
+}
+
+// --- Helper: P4, one memcpy per row plus a trim of the padding bits ---
+static void ReadBinaryRaster(PBMFile *file, const PBMImage *image,
+                             uint32_t *pixels) {
+  size_t stride = (size_t)image->width_in_words * 4;
+  size_t row_bytes = ((size_t)image->width + 7) / 8;
+  uint8_t tail_mask = (uint8_t)(0xFF << ((8 - image->width % 8) % 8));
+
+  size_t available = file->size - file->cursor;
+  size_t needed = row_bytes * image->height;
+  if (available < needed) {
+    std::cerr << "Warning: File " << file->filename
+              << " ended early (Corrupt?)" << std::endl;
+  }
+
+  uint8_t *dst = (uint8_t *)pixels;
+  const uint8_t *src = file->data + file->cursor;
+  for (int32_t y = 0; y < image->height; y++) {
+    size_t offset = (size_t)y * row_bytes;
+    size_t copy = 0;
+    if (offset < available)
+      copy = (available - offset < row_bytes) ? available - offset : row_bytes;
+
+    memcpy(dst, src + offset, copy);
+    memset(dst + copy, 0, stride - copy);
+    dst[row_bytes - 1] &= tail_mask;
+    dst += stride;
+  }
+
+  file->cursor += (available < needed) ? available : needed;
+}
+
+// --- Helper: P1, one '0' / '1' character per pixel ---
+static bool ReadAsciiRaster(PBMFile *file, const PBMImage *image,
+                            uint32_t *pixels) {
+  size_t stride = (size_t)image->width_in_words * 4;
+  memset(pixels, 0, stride * image->height);
+
+  uint8_t *row = (uint8_t *)pixels;
+  for (int32_t y = 0; y < image->height; y++) {
+    for (int32_t x = 0; x < image->width; x++) {
+      SkipSpaceAndComments(file);
+      if (file->cursor >= file->size) {
+        std::cerr << "Warning: File " << file->filename
+                  << " ended early (Corrupt?)" << std::endl;
+        return true;
+      }
+
+      uint8_t c = file->data[file->cursor++];
+      if (c == '1') {
+        row[x >> 3] |= (uint8_t)(0x80 >> (x & 7));
+      } else if (c != '0') {
+        std::cerr << "Error: Invalid P1 pixel in " << file->filename
+                  << std::endl;
+        return false;
+      }
+    }
+    row += stride;
+  }
+  return true;
+}
+
+bool PBM_ReadRaster(PBMFile *file, const PBMImage *image, uint32_t *pixels) {
+  if (image->format == '1')
+    return ReadAsciiRaster(file, image, pixels);
+
+  ReadBinaryRaster(file, image, pixels);
+  return true;
+}
@@ -0,0 +1,57 @@
+#ifndef PBM_H
+#define PBM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared PBM parser used by every image loader.
+// The whole file is read with a single read into one buffer and the headers
+// are parsed from memory. Accepts binary (P4) and ASCII (P1) images of any
+// width, and files holding several images back to back (sprite sheets,
+// e.g. 'cat a.pbm b.pbm > sheet.pbm'), which are decoded in one pass.
+//
+// Rows are decoded in memory order (left-most pixel in the top bit of the
+// first byte, see pixelword.h) and padded to whole 32-bit words. Padding
+// bits are always 0, i.e. transparent, so a sprite still works as its own
+// mask whatever its width.
+
+typedef struct {
+  uint8_t *data;        // Whole file, malloc'd
+  size_t size;
+  size_t cursor;        // Start of the next image
+  const char *filename; // For error messages
+} PBMFile;
+
+typedef struct {
+  int32_t width;
+  int32_t height;
+  int32_t width_in_words; // Padded stride: (width + 31) / 32
+  char format;            // '1' (ASCII) or '4' (binary)
+} PBMImage;
+
+// Reads 'filename' into memory. Returns false (and reports why) if it cannot
+// be opened or read.
+bool PBM_Open(PBMFile *file, const char *filename);
+void PBM_Close(PBMFile *file);
+
+// True if another image follows the cursor (only whitespace is left
+// otherwise).
+bool PBM_HasImage(PBMFile *file);
+
+// Parses the header of the image at the cursor and leaves the cursor on its
+// raster. Returns false on a format error.
+bool PBM_ReadHeader(PBMFile *file, PBMImage *image);
+
+// Decodes the raster at the cursor into 'pixels' (height rows of
+// width_in_words words) and moves the cursor to the next image. A truncated
+// raster is zero-filled with a warning; bad ASCII data fails.
+bool PBM_ReadRaster(PBMFile *file, const PBMImage *image, uint32_t *pixels);
+
+// Upper bound on the decoded pixel bytes of any PBM file of 'file_size'
+// bytes. Padding a row to words grows it by at most 4x (one byte on disk,
+// one word in memory); ASCII rasters only shrink.
+static inline size_t PBM_MaxPixelBytes(size_t file_size) {
+  return file_size * 4;
+}
+
+#endif // PBM_H
@@ -0,0 +1,29 @@
+#ifndef PIXELWORD_H
+#define PIXELWORD_H
+
+#include <stdint.h>
+
+// Sprites, backgrounds and canvases all store rows as MSB-first bytes (PBM /
+// DIB order). Any code that shifts pixels across byte boundaries must work on
+// "pixel words" instead, where the left-most pixel of a 32-pixel group is
+// bit 31. These convert between the two; on big-endian hosts they are no-ops.
+
+static inline uint32_t LoadPixelWord(const uint32_t *p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return *p;
+#else
+  return __builtin_bswap32(*p);
+#endif
+}
+
+// Converts a pixel word back to memory order, so it can be combined with
+// stored words using plain AND / OR / XOR.
+static inline uint32_t ToMemoryWord(uint32_t pixel_word) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return pixel_word;
+#else
+  return __builtin_bswap32(pixel_word);
+#endif
+}
+
+#endif // PIXELWORD_H
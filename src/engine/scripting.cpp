@@ -11,13 +11,25 @@ extern "C" {
 
 // Game & Asset Includes
 #include "../game.h" // Access to Game struct
-#include "bkgimageassetentry.h"
+#include "arena.h"
+#include "assetloader.h"
 #include "bkgimagefileloader.h"
+#include "bkgimageregistry.h"
+#include "hotreload.h"
 
+#include <cstring>
 #include <iostream>
 
+// Metatable that tags the userdata Engine.LoadSound returns
+#define SOUND_ID_METATABLE "SoundID"
+
+// Marks a behaviour slot removed mid-dispatch, until the pass compacts it
+#define BEHAVIOUR_REMOVED 0xFFFFFFFFu
+
 ScriptManager::ScriptManager()
-    : L(nullptr), engine_ref(nullptr), registry_ref(nullptr) {}
+    : L(nullptr), engine_ref(nullptr), registry_ref(nullptr),
+      update_ref(LUA_NOREF), behaviour_functions(LUA_NOREF),
+      behaviour_selves(LUA_NOREF) {}
 
 ScriptManager::~ScriptManager() { shutdown(); }
 
@@ -27,10 +39,17 @@ ScriptManager::~ScriptManager() { shutdown(); }
 // Removing the one at the top.
 
 void ScriptManager::shutdown() {
+  if (registry_ref)
+    registry_ref->set_destroy_callback(nullptr, nullptr);
   if (L) {
     lua_close(L);
     L = nullptr;
   }
+  update_ref = LUA_NOREF;
+  behaviour_functions = LUA_NOREF;
+  behaviour_selves = LUA_NOREF;
+  behaviour_entities.clear();
+  behaviour_slots.clear();
 }
 
 bool ScriptManager::load_script(const std::string &filepath) {
@@ -52,19 +71,164 @@ void ScriptManager::run_script() {
   // succeeded. However, if we called load_script separately, we might need to
   // handle this differently. For now, let's assume load_script pushes the
   // chunk, and run_script executes it. Actually, safe pattern: reload and run.
+  reload_pending = false;
+
+  // A hook the new version no longer defines must not outlive the old one
+  lua_pushnil(L);
+  lua_setglobal(L, "on_update");
 
   if (luaL_dofile(L, current_script.c_str()) != 0) {
     std::cerr << "Runtime error in script: " << current_script << "\n"
               << lua_tostring(L, -1) << std::endl;
+    lua_pop(L, 1);
   } else {
     std::cout << "Script " << current_script << " executed successfully."
               << std::endl;
   }
+  resolve_hooks();
+}
+
+// Looks up the script's global hooks once, instead of on every call
+void ScriptManager::resolve_hooks() {
+  luaL_unref(L, LUA_REGISTRYINDEX, update_ref);
+  update_ref = LUA_NOREF;
+
+  lua_getglobal(L, "on_update");
+  if (lua_isfunction(L, -1))
+    update_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+  else
+    lua_pop(L, 1);
+}
+
+void ScriptManager::update(float dt) {
+  if (!L)
+    return;
+  int base = lua_gettop(L);
+
+  // 1. The script-wide hook
+  if (update_ref != LUA_NOREF) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, update_ref);
+    lua_pushnumber(L, dt);
+    if (lua_pcall(L, 1, 0, 0) != 0) {
+      std::cerr << "Runtime error in on_update (disabled until reload):\n"
+                << lua_tostring(L, -1) << std::endl;
+      lua_pop(L, 1);
+      luaL_unref(L, LUA_REGISTRYINDEX, update_ref);
+      update_ref = LUA_NOREF;
+    }
+  }
+
+  // 2. Every behaviour, with both arrays pushed once for the whole pass.
+  // Behaviours added meanwhile first run next frame.
+  int count = (int)behaviour_entities.size();
+  if (count == 0)
+    return;
+
+  lua_rawgeti(L, LUA_REGISTRYINDEX, behaviour_functions);
+  lua_rawgeti(L, LUA_REGISTRYINDEX, behaviour_selves);
+  int functions = base + 1;
+  int selves = base + 2;
+
+  dispatching = true;
+  for (int slot = 0; slot < count; slot++) {
+    uint32_t id = behaviour_entities[slot];
+    if (id == BEHAVIOUR_REMOVED)
+      continue;
+
+    lua_rawgeti(L, functions, slot + 1);
+    lua_rawgeti(L, selves, slot + 1);
+    lua_pushnumber(L, dt);
+    if (lua_pcall(L, 2, 0, 0) != 0) {
+      std::cerr << "Runtime error in behaviour of entity " << id
+                << " (removed):\n"
+                << lua_tostring(L, -1) << std::endl;
+      lua_pop(L, 1);
+      remove_behaviour(id);
+    }
+  }
+  dispatching = false;
+  lua_settop(L, base);
+
+  // 3. Compact what was removed during the pass. Walking down, the slot
+  // swapped into a gap has already been checked.
+  if (removal_pending) {
+    for (int slot = (int)behaviour_entities.size() - 1; slot >= 0; slot--) {
+      if (behaviour_entities[slot] == BEHAVIOUR_REMOVED)
+        remove_behaviour_slot(slot);
+    }
+    removal_pending = false;
+  }
+}
+
+// Gives entity 'id' the function at 'function_index'. An entity that
+// already has a behaviour keeps its 'self' table, and with it its state.
+void ScriptManager::set_behaviour(uint32_t id, int function_index) {
+  if (id >= behaviour_slots.size())
+    behaviour_slots.resize(id + 1, -1);
+
+  int slot = behaviour_slots[id];
+  if (slot < 0) {
+    slot = (int)behaviour_entities.size();
+    behaviour_entities.push_back(id);
+    behaviour_slots[id] = slot;
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, behaviour_selves);
+    lua_createtable(L, 0, 1);
+    lua_pushinteger(L, (lua_Integer)id);
+    lua_setfield(L, -2, "id");
+    lua_rawseti(L, -2, slot + 1);
+    lua_pop(L, 1);
+  }
+
+  lua_rawgeti(L, LUA_REGISTRYINDEX, behaviour_functions);
+  lua_pushvalue(L, function_index);
+  lua_rawseti(L, -2, slot + 1);
+  lua_pop(L, 1);
+}
+
+void ScriptManager::remove_behaviour(uint32_t id) {
+  if (!L || id >= behaviour_slots.size() || behaviour_slots[id] < 0)
+    return;
+
+  int slot = behaviour_slots[id];
+  behaviour_slots[id] = -1;
+  if (dispatching) {
+    // Slots must not move under the running pass
+    behaviour_entities[slot] = BEHAVIOUR_REMOVED;
+    removal_pending = true;
+    return;
+  }
+  remove_behaviour_slot(slot);
+}
+
+// Swap-and-pop, in the two Lua arrays and in the slot vectors alike
+void ScriptManager::remove_behaviour_slot(int slot) {
+  int last = (int)behaviour_entities.size() - 1;
+  int refs[2] = {behaviour_functions, behaviour_selves};
+
+  for (int i = 0; i < 2; i++) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, refs[i]);
+    if (slot != last) {
+      lua_rawgeti(L, -1, last + 1);
+      lua_rawseti(L, -2, slot + 1);
+    }
+    lua_pushnil(L);
+    lua_rawseti(L, -2, last + 1);
+    lua_pop(L, 1);
+  }
+
+  if (slot != last) {
+    uint32_t moved = behaviour_entities[last];
+    behaviour_entities[slot] = moved;
+    if (moved != BEHAVIOUR_REMOVED)
+      behaviour_slots[moved] = slot;
+  }
+  behaviour_entities.pop_back();
 }
 
 void ScriptManager::reload() {
   std::cout << "Reloading script..." << std::endl;
-  run_script();
+  reload_pending = true;
 }
 
 // ================= Bindings ================= //
@@ -88,15 +252,48 @@ void ScriptManager::register_bindings() {
   lua_pushcclosure(L, lua_SetVelocity, 0);
   lua_setfield(L, -2, "SetVelocity");
 
+  lua_pushcclosure(L, lua_GetPositions, 0);
+  lua_setfield(L, -2, "GetPositions");
+
+  lua_pushcclosure(L, lua_SetPositions, 0);
+  lua_setfield(L, -2, "SetPositions");
+
+  lua_pushcclosure(L, lua_GetVelocities, 0);
+  lua_setfield(L, -2, "GetVelocities");
+
+  lua_pushcclosure(L, lua_SetVelocities, 0);
+  lua_setfield(L, -2, "SetVelocities");
+
+  lua_pushcclosure(L, lua_LoadSound, 0);
+  lua_setfield(L, -2, "LoadSound");
+
   lua_pushcclosure(L, lua_PlaySound, 0);
   lua_setfield(L, -2, "PlaySound");
 
+  lua_pushcclosure(L, lua_StopSound, 0);
+  lua_setfield(L, -2, "StopSound");
+
+  lua_pushcclosure(L, lua_PlayMusic, 0);
+  lua_setfield(L, -2, "PlayMusic");
+
+  lua_pushcclosure(L, lua_StopMusic, 0);
+  lua_setfield(L, -2, "StopMusic");
+
   lua_pushcclosure(L, lua_GetTime, 0);
   lua_setfield(L, -2, "GetTime");
 
   lua_pushcclosure(L, lua_SetBackgroundImage, 0);
   lua_setfield(L, -2, "SetBackgroundImage");
 
+  lua_pushcclosure(L, lua_LoadAsync, 0);
+  lua_setfield(L, -2, "LoadAsync");
+
+  lua_pushcclosure(L, lua_GetLoadStatus, 0);
+  lua_setfield(L, -2, "GetLoadStatus");
+
+  lua_pushcclosure(L, lua_SetBehaviour, 0);
+  lua_setfield(L, -2, "SetBehaviour");
+
   lua_setglobal(L, "Engine");
 }
 
@@ -158,6 +355,15 @@ bool ScriptManager::init(Game *game, Engine *engine, Registry *registry) {
 
   // Note: luaL_openlibs(L) removed.
   register_bindings();
+  luaL_newmetatable(L, SOUND_ID_METATABLE);
+  lua_pop(L, 1);
+
+  // 6. The dense behaviour arrays, see update()
+  lua_newtable(L);
+  behaviour_functions = luaL_ref(L, LUA_REGISTRYINDEX);
+  lua_newtable(L);
+  behaviour_selves = luaL_ref(L, LUA_REGISTRYINDEX);
+  registry->set_destroy_callback(on_entity_destroyed, this);
   return true;
 }
 
@@ -171,24 +377,46 @@ int ScriptManager::lua_CreateEntity(lua_State *L) {
 }
 
 int ScriptManager::lua_SetSprite(lua_State *L) {
-  if (!g_ScriptManager)
+  if (!g_ScriptManager || !g_ScriptManager->game_ref)
     return 0;
   int id = luaL_checkinteger(L, 1);
   const char *spriteName = luaL_checkstring(L, 2);
+  if (id < 0 || !g_ScriptManager->registry_ref->is_alive((EntityID)id))
+    return luaL_error(L, "SetSprite: no entity %d", id);
+
+  // 1. Resolve the name (full name compare, so no collisions)
+  Game *game = g_ScriptManager->game_ref;
+  Sprite *sprite = AssetRegistry_Find(&game->sprite_registry, spriteName);
+  if (!sprite)
+    return luaL_error(L, "SetSprite: unknown sprite '%s'", spriteName);
+
+  // 2. Swap the sprite of the entity's drawable, or give it one
+  Engine *engine = g_ScriptManager->engine_ref;
+  Registry *registry = g_ScriptManager->registry_ref;
+  DrawableComponent *ref = registry->get_drawable_ref(id);
+  if (ref && ref->type == DrawableType::FOREGROUND) {
+    ForegroundDrawable *fd =
+        engine->get_foreground_drawable(ref->drawable_index);
+    if (fd) {
+      fd->sprite = sprite;
+      fd->mask = Sprite_Mask(sprite);
+    }
+    return 0;
+  }
 
-  // We need to resolve the Sprite* from the name.
-  // game.cpp has the sprite_table. Engine doesn't own it directly?
-  // Engine owns drawables but not the asset table directly in current
-  // architecture? Checking game.cpp... game.cpp has `sprite_table`. Use Case:
-  // We might need to look up assets via Engine if we move asset manager there.
-  // OPTION: Pass sprite_table to ScriptManager or expose a getter on Engine?
-  // For now, let's assume we can't look it up yet without a change.
-  // Wait, Engine doesn't have `get_sprite(name)`.
-  // FIXME: We need a way to look up sprites.
-
-  // Temporary Hack: Just log it to prove binding works, or fail gracefully.
-  std::cout << "[Lua] SetSprite(" << id << ", " << spriteName
-            << ") - Asset Lookup Not Implemented Yet" << std::endl;
+  DisplaceableComponent *d = registry->get_displaceable(id);
+  ForegroundDrawable fd;
+  fd.sprite = sprite;
+  fd.mask = Sprite_Mask(sprite);
+  fd.sort_key = 0;
+  fd.flags = 0;
+  fd.owner_id = (uint32_t)id;
+  fd.x = d ? (int16_t)d->x : 0;
+  fd.y = d ? (int16_t)d->y : 0;
+
+  int index = engine->add_foreground_drawable(fd);
+  if (index >= 0)
+    registry->set_drawable_ref(id, DrawableType::FOREGROUND, index);
   return 0;
 }
 
@@ -199,22 +427,14 @@ int ScriptManager::lua_SetPosition(lua_State *L) {
   double x = luaL_checknumber(L, 2);
   double y = luaL_checknumber(L, 3);
 
-  // Update Displaceable
+  // Created if missing, velocity kept otherwise. The main loop syncs the
+  // drawable.
   DisplaceableComponent *d =
-      g_ScriptManager->registry_ref->get_displaceable(id);
-  // If not exists, we might need to create it?
-  // Registry::set_displaceable creates or updates.
-  // We need current vx, vy to preserve them?
-  float vx = 0, vy = 0;
+      g_ScriptManager->registry_ref->add_displaceable(id);
   if (d) {
-    vx = d->vx;
-    vy = d->vy;
+    d->x = (float)x;
+    d->y = (float)y;
   }
-
-  g_ScriptManager->registry_ref->set_displaceable(id, (float)x, (float)y, vx,
-                                                  vy);
-
-  // Also update Drawable if exists? The main loop does sync.
   return 0;
 }
 
@@ -226,23 +446,210 @@ int ScriptManager::lua_SetVelocity(lua_State *L) {
   double vy = luaL_checknumber(L, 3);
 
   DisplaceableComponent *d =
-      g_ScriptManager->registry_ref->get_displaceable(id);
-  float x_val = 0, y_val = 0;
+      g_ScriptManager->registry_ref->add_displaceable(id);
   if (d) {
-    x_val = d->x;
-    y_val = d->y;
+    d->vx = (float)vx;
+    d->vy = (float)vy;
+  }
+  return 0;
+}
+
+// --- Bulk accessors ---
+// One call moves a whole array of entities, instead of one Lua -> C
+// crossing (and its argument checks) per entity. Pairs are flat:
+// {x1, y1, x2, y2, ...} for the entity ids {id1, id2, ...}. Reading into a
+// table passed back in every frame allocates nothing once it has grown.
+
+// --- Helper: Fills table 'out' (or a new one) with a pair per id ---
+static int GetPairs(lua_State *L, Registry *registry, bool velocity) {
+  luaL_checktype(L, 1, LUA_TTABLE);
+  int count = (int)lua_objlen(L, 1);
+  if (lua_isnoneornil(L, 2)) {
+    lua_settop(L, 1);
+    lua_createtable(L, count * 2, 0);
+  } else {
+    luaL_checktype(L, 2, LUA_TTABLE);
+    lua_settop(L, 2);
+  }
+
+  for (int i = 0; i < count; i++) {
+    lua_rawgeti(L, 1, i + 1);
+    EntityID id = (EntityID)lua_tointeger(L, -1);
+    lua_pop(L, 1);
+
+    // Entities without the component read as 0, 0
+    DisplaceableComponent *d = registry->get_displaceable(id);
+    float a = 0, b = 0;
+    if (d) {
+      a = velocity ? d->vx : d->x;
+      b = velocity ? d->vy : d->y;
+    }
+    lua_pushnumber(L, a);
+    lua_rawseti(L, 2, i * 2 + 1);
+    lua_pushnumber(L, b);
+    lua_rawseti(L, 2, i * 2 + 2);
+  }
+  return 1;
+}
+
+// --- Helper: Applies a pair per id, creating the component if missing ---
+// Everything is read into frame arena scratch and checked first, so a bad
+// value raises the error before any entity has changed.
+static int SetPairs(lua_State *L, Engine *engine, Registry *registry,
+                    bool velocity) {
+  luaL_checktype(L, 1, LUA_TTABLE);
+  luaL_checktype(L, 2, LUA_TTABLE);
+  int count = (int)lua_objlen(L, 1);
+  if ((int)lua_objlen(L, 2) < count * 2)
+    return luaL_argerror(L, 2,
+                         lua_pushfstring(L, "%d values expected for %d ids",
+                                         count * 2, count));
+  if (count == 0)
+    return 0;
+
+  // 1. Stage the ids and values
+  EntityID *ids = (EntityID *)Arena_Alloc(
+      engine->frame_arena(), sizeof(EntityID) * count, alignof(EntityID));
+  float *values = (float *)Arena_Alloc(
+      engine->frame_arena(), sizeof(float) * count * 2, alignof(float));
+  if (!ids || !values)
+    return luaL_error(L, "out of frame memory for %d entities", count);
+
+  for (int i = 0; i < count; i++) {
+    lua_rawgeti(L, 1, i + 1);
+    if (!lua_isnumber(L, -1))
+      return luaL_argerror(L, 1, "entity ids expected");
+    ids[i] = (EntityID)lua_tointeger(L, -1);
+    lua_pop(L, 1);
+  }
+  for (int i = 0; i < count * 2; i++) {
+    lua_rawgeti(L, 2, i + 1);
+    if (!lua_isnumber(L, -1))
+      return luaL_argerror(L, 2, "numbers expected");
+    values[i] = (float)lua_tonumber(L, -1);
+    lua_pop(L, 1);
   }
 
-  g_ScriptManager->registry_ref->set_displaceable(id, x_val, y_val, (float)vx,
-                                                  (float)vy);
+  // 2. Apply them in one tight loop
+  for (int i = 0; i < count; i++) {
+    DisplaceableComponent *d = registry->add_displaceable(ids[i]);
+    if (!d)
+      continue;
+    if (velocity) {
+      d->vx = values[i * 2];
+      d->vy = values[i * 2 + 1];
+    } else {
+      d->x = values[i * 2];
+      d->y = values[i * 2 + 1];
+    }
+  }
   return 0;
 }
 
+// Engine.GetPositions(ids [, out]) -> out: {x1, y1, x2, y2, ...}
+int ScriptManager::lua_GetPositions(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  return GetPairs(L, g_ScriptManager->registry_ref, false);
+}
+
+// Engine.SetPositions(ids, {x1, y1, x2, y2, ...})
+int ScriptManager::lua_SetPositions(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  return SetPairs(L, g_ScriptManager->engine_ref,
+                  g_ScriptManager->registry_ref, false);
+}
+
+// Engine.GetVelocities(ids [, out]) -> out: {vx1, vy1, vx2, vy2, ...}
+int ScriptManager::lua_GetVelocities(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  return GetPairs(L, g_ScriptManager->registry_ref, true);
+}
+
+// Engine.SetVelocities(ids, {vx1, vy1, vx2, vy2, ...})
+int ScriptManager::lua_SetVelocities(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  return SetPairs(L, g_ScriptManager->engine_ref,
+                  g_ScriptManager->registry_ref, true);
+}
+
+// Engine.LoadSound(path) -> sound, or nil if it could not be loaded.
+// Resolve sounds once (e.g. at the top of a script) and play the result:
+// the SoundID is 64 bits, more than a Lua 5.1 number holds exactly, so it
+// travels in a small userdata.
+int ScriptManager::lua_LoadSound(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  const char *path = luaL_checkstring(L, 1);
+  SoundID id = g_ScriptManager->engine_ref->load_sound(path);
+  if (!id) {
+    lua_pushnil(L);
+    return 1;
+  }
+  SoundID *sound = (SoundID *)lua_newuserdata(L, sizeof(SoundID));
+  *sound = id;
+  luaL_getmetatable(L, SOUND_ID_METATABLE);
+  lua_setmetatable(L, -2);
+  return 1;
+}
+
+// Engine.PlaySound(sound) -> voice handle. Also takes a path, which is
+// hashed (and loaded if needed) on every call. A nil sound (one LoadSound
+// could not load) plays nothing and returns voice 0.
 int ScriptManager::lua_PlaySound(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+
+  VoiceHandle voice;
+  if (lua_isnoneornil(L, 1)) {
+    voice = 0;
+  } else if (lua_type(L, 1) == LUA_TUSERDATA) {
+    SoundID id = *(const SoundID *)luaL_checkudata(L, 1, SOUND_ID_METATABLE);
+    voice = g_ScriptManager->engine_ref->play_sound(id);
+  } else {
+    const char *path = luaL_checkstring(L, 1);
+    voice = g_ScriptManager->engine_ref->play_sound(path);
+  }
+  lua_pushinteger(L, (lua_Integer)voice);
+  return 1;
+}
+
+int ScriptManager::lua_StopSound(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  VoiceHandle voice = (VoiceHandle)luaL_checkinteger(L, 1);
+  g_ScriptManager->engine_ref->stop_sound(voice);
+  return 0;
+}
+
+// Engine.PlayMusic(path [, fade [, loop [, loop_start [, loop_end]]]])
+// -> true if the track started. Times in seconds, like GetTime; loops by
+// default, over the whole file unless loop points are given.
+int ScriptManager::lua_PlayMusic(lua_State *L) {
   if (!g_ScriptManager)
     return 0;
   const char *path = luaL_checkstring(L, 1);
-  g_ScriptManager->engine_ref->play_sound(path);
+  double fade = luaL_optnumber(L, 2, 0.0);
+  bool loop = lua_isnoneornil(L, 3) ? true : lua_toboolean(L, 3) != 0;
+  double loop_start = luaL_optnumber(L, 4, 0.0);
+  double loop_end = luaL_optnumber(L, 5, 0.0);
+
+  bool ok = g_ScriptManager->engine_ref->play_music(
+      path, (uint32_t)(fade * 1000.0), loop, (uint32_t)(loop_start * 1000.0),
+      (uint32_t)(loop_end * 1000.0));
+  lua_pushboolean(L, ok);
+  return 1;
+}
+
+// Engine.StopMusic([fade]): fades out over 'fade' seconds
+int ScriptManager::lua_StopMusic(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  double fade = luaL_optnumber(L, 1, 0.0);
+  g_ScriptManager->engine_ref->stop_music((uint32_t)(fade * 1000.0));
   return 0;
 }
 
@@ -265,7 +672,7 @@ int ScriptManager::lua_SetBackgroundImage(lua_State *L) {
   Game *game = g_ScriptManager->game_ref;
 
   // 1. Check if already loaded
-  BkgImage *bkg = GetBkgImage(game->bkg_table, BKG_TABLE_SIZE, path);
+  BkgImage *bkg = AssetRegistry_Find(&game->bkg_registry, path);
 
   // 2. If not, load it
   if (!bkg) {
@@ -276,7 +683,8 @@ int ScriptManager::lua_SetBackgroundImage(lua_State *L) {
       luaL_error(L, "Failed to load background image: %s", path);
       return 0;
     }
-    RegisterBkgImageAsAsset(game->bkg_table, BKG_TABLE_SIZE, path, bkg);
+    AssetRegistry_Add(&game->bkg_registry, path, bkg);
+    HotReload_Track(&game->hot_reload, path, HOT_RELOAD_BKGIMAGE, bkg);
   }
 
   // 3. Set Active
@@ -284,3 +692,118 @@ int ScriptManager::lua_SetBackgroundImage(lua_State *L) {
 
   return 0;
 }
+
+// Engine.LoadAsync(kind, path [, priority [, callback]]) -> handle
+// kind: "sprite", "bkg" or "sound". priority: "urgent", "normal" (default),
+// "prefetch" or 0..2. callback(handle, ok) runs at a frame boundary.
+int ScriptManager::lua_LoadAsync(lua_State *L) {
+  if (!g_ScriptManager || !g_ScriptManager->game_ref)
+    return 0;
+
+  const char *kind = luaL_checkstring(L, 1);
+  const char *path = luaL_checkstring(L, 2);
+
+  // 1. Asset type
+  uint16_t type;
+  if (strcmp(kind, "sprite") == 0)
+    type = ASSET_TYPE_SPRITE;
+  else if (strcmp(kind, "bkg") == 0)
+    type = ASSET_TYPE_BKGIMAGE;
+  else if (strcmp(kind, "sound") == 0)
+    type = ASSET_TYPE_SOUND;
+  else
+    return luaL_error(L, "LoadAsync: unknown asset kind '%s'", kind);
+
+  // 2. Priority
+  int priority = ASSET_PRIORITY_NORMAL;
+  if (lua_type(L, 3) == LUA_TSTRING) {
+    const char *name = lua_tostring(L, 3);
+    if (strcmp(name, "urgent") == 0)
+      priority = ASSET_PRIORITY_URGENT;
+    else if (strcmp(name, "prefetch") == 0)
+      priority = ASSET_PRIORITY_PREFETCH;
+    else if (strcmp(name, "normal") != 0)
+      return luaL_error(L, "LoadAsync: unknown priority '%s'", name);
+  } else if (!lua_isnoneornil(L, 3)) {
+    priority = (int)luaL_checkinteger(L, 3);
+  }
+
+  // 3. Optional callback, kept alive in the registry until it has run
+  int ref = LUA_NOREF;
+  if (!lua_isnoneornil(L, 4)) {
+    luaL_checktype(L, 4, LUA_TFUNCTION);
+    lua_pushvalue(L, 4);
+    ref = luaL_ref(L, LUA_REGISTRYINDEX);
+  }
+
+  AssetLoadHandle handle = AssetLoader_Request(
+      &g_ScriptManager->game_ref->asset_loader, type, path, priority,
+      ref != LUA_NOREF ? on_async_load : nullptr, (void *)(intptr_t)ref);
+
+  if (handle == 0 && ref != LUA_NOREF)
+    luaL_unref(L, LUA_REGISTRYINDEX, ref);
+
+  lua_pushinteger(L, (lua_Integer)handle);
+  return 1;
+}
+
+// Engine.GetLoadStatus(handle) -> "queued", "loading", "loaded", "failed",
+// "cancelled" or "unknown"
+int ScriptManager::lua_GetLoadStatus(lua_State *L) {
+  if (!g_ScriptManager || !g_ScriptManager->game_ref)
+    return 0;
+
+  AssetLoadHandle handle = (AssetLoadHandle)luaL_checkinteger(L, 1);
+  AssetLoadStatus status =
+      AssetLoader_Status(&g_ScriptManager->game_ref->asset_loader, handle);
+
+  static const char *const names[] = {"unknown", "queued", "loading",
+                                      "loaded",  "failed", "cancelled"};
+  lua_pushstring(L, names[status]);
+  return 1;
+}
+
+// Engine.SetBehaviour(id, fn): calls fn(self, dt) every frame, where
+// 'self' is a table that lives as long as the behaviour ({id = id} to
+// begin with, free for the script's own state). A nil fn removes it.
+// Destroying the entity removes it too.
+int ScriptManager::lua_SetBehaviour(lua_State *L) {
+  if (!g_ScriptManager)
+    return 0;
+  int id = luaL_checkinteger(L, 1);
+  if (id < 0 || !g_ScriptManager->registry_ref->is_alive((EntityID)id))
+    return luaL_error(L, "SetBehaviour: no entity %d", id);
+
+  if (lua_isnoneornil(L, 2)) {
+    g_ScriptManager->remove_behaviour((uint32_t)id);
+    return 0;
+  }
+  luaL_checktype(L, 2, LUA_TFUNCTION);
+  g_ScriptManager->set_behaviour((uint32_t)id, 2);
+  return 0;
+}
+
+void ScriptManager::on_async_load(uint32_t handle, bool success, void *asset,
+                                  void *user_data) {
+  (void)asset;
+  if (!g_ScriptManager || !g_ScriptManager->L)
+    return;
+
+  lua_State *L = g_ScriptManager->L;
+  int ref = (int)(intptr_t)user_data;
+
+  lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+  luaL_unref(L, LUA_REGISTRYINDEX, ref);
+  lua_pushinteger(L, (lua_Integer)handle);
+  lua_pushboolean(L, success);
+
+  if (lua_pcall(L, 2, 0, 0) != 0) {
+    std::cerr << "Runtime error in LoadAsync callback:\n"
+              << lua_tostring(L, -1) << std::endl;
+    lua_pop(L, 1);
+  }
+}
+
+void ScriptManager::on_entity_destroyed(uint32_t id, void *user_data) {
+  ((ScriptManager *)user_data)->remove_behaviour(id);
+}
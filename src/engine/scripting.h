@@ -1,6 +1,8 @@
 #pragma once
 
+#include <stdint.h>
 #include <string>
+#include <vector>
 
 // Forward declaration to avoid including lua headers in game.h
 extern "C" {
@@ -22,24 +24,73 @@ public:
   bool load_script(const std::string &filepath);
   void run_script();
 
-  // Allow reloading for iteration
+  // Allow reloading for iteration. Re-running the script on top of what it
+  // already created would duplicate its entities, loads and sounds, so this
+  // only flags the request: the game restarts the level, which tears all of
+  // that down, and the level runs the new script (see Game::update).
   void reload();
+  bool reload_requested() const { return reload_pending; }
+  const std::string &get_current_script() const { return current_script; }
+
+  // Per-frame hooks. Calls the script's global on_update(dt), then every
+  // entity behaviour (see Engine.SetBehaviour) as fn(self, dt), in one pass.
+  // The functions and 'self' tables are looked up once, when they are set,
+  // and kept in dense Lua arrays, so a frame costs one array read and one
+  // pcall per behaviour. A hook that raises an error is dropped.
+  void update(float dt);
+  // Detaches an entity's behaviour (e.g. when the game destroys it)
+  void remove_behaviour(uint32_t id);
 
 private:
   void register_bindings();
+  void resolve_hooks();
+  void set_behaviour(uint32_t id, int function_index);
+  void remove_behaviour_slot(int slot);
 
   // Bindings
   static int lua_CreateEntity(lua_State *L);
   static int lua_SetSprite(lua_State *L);
   static int lua_SetPosition(lua_State *L);
   static int lua_SetVelocity(lua_State *L);
+  static int lua_GetPositions(lua_State *L);
+  static int lua_SetPositions(lua_State *L);
+  static int lua_GetVelocities(lua_State *L);
+  static int lua_SetVelocities(lua_State *L);
+  static int lua_LoadSound(lua_State *L);
   static int lua_PlaySound(lua_State *L);
+  static int lua_StopSound(lua_State *L);
+  static int lua_PlayMusic(lua_State *L);
+  static int lua_StopMusic(lua_State *L);
   static int lua_GetTime(lua_State *L);
   static int lua_SetBackgroundImage(lua_State *L);
+  static int lua_LoadAsync(lua_State *L);
+  static int lua_GetLoadStatus(lua_State *L);
+  static int lua_SetBehaviour(lua_State *L);
+
+  // AssetLoadCallback for LoadAsync; 'user_data' is the callback's Lua ref
+  static void on_async_load(uint32_t handle, bool success, void *asset,
+                            void *user_data);
+  // EntityDestroyCallback: a destroyed entity loses its behaviour
+  static void on_entity_destroyed(uint32_t id, void *user_data);
 
   lua_State *L = nullptr;
   Engine *engine_ref = nullptr;
   Registry *registry_ref = nullptr;
   Game *game_ref = nullptr;
   std::string current_script;
+
+  // Lua registry references (LUA_NOREF when unset)
+  int update_ref;          // The script's on_update
+  int behaviour_functions; // Array: slot + 1 -> behaviour function
+  int behaviour_selves;    // Array: slot + 1 -> 'self' table of the entity
+
+  // Dense behaviour slots, mirrored by the two Lua arrays
+  std::vector<uint32_t> behaviour_entities; // Slot -> entity
+  std::vector<int> behaviour_slots;         // Entity -> slot, -1 if none
+
+  // Set during update(); removals wait until the pass is over
+  bool dispatching = false;
+  bool removal_pending = false;
+
+  bool reload_pending = false; // See reload()
 };
@@ -0,0 +1,197 @@
+#include "shiftcache.h"
+#include "pixelword.h"
+#include <iostream>
+#include <string.h>
+
+// --- Helper: Hash a (sprite, mask, shift) key ---
+static inline uint32_t HashKey(const Sprite *sprite, const Sprite *mask,
+                               int shift) {
+  uint64_t h = (uint64_t)(uintptr_t)sprite * 0x9E3779B97F4A7C15ull;
+  h ^= (uint64_t)(uintptr_t)mask * 0xC2B2AE3D27D4EB4Full;
+  h ^= (uint64_t)shift * 0x165667B19E3779F9ull;
+  return (uint32_t)(h >> 32);
+}
+
+static inline bool SlotMatches(const ShiftCacheSlot *slot, const Sprite *sprite,
+                               const Sprite *mask, int shift) {
+  return slot->sprite == sprite && slot->mask == mask &&
+         slot->variant.shift == shift;
+}
+
+// --- Helper: LRU list maintenance ---
+static void LruUnlink(ShiftCache *cache, uint16_t index) {
+  ShiftCacheSlot *slot = &cache->slots[index];
+  if (slot->lru_prev != SHIFTCACHE_EMPTY)
+    cache->slots[slot->lru_prev].lru_next = slot->lru_next;
+  else
+    cache->lru_head = slot->lru_next;
+
+  if (slot->lru_next != SHIFTCACHE_EMPTY)
+    cache->slots[slot->lru_next].lru_prev = slot->lru_prev;
+  else
+    cache->lru_tail = slot->lru_prev;
+}
+
+static void LruPushFront(ShiftCache *cache, uint16_t index) {
+  ShiftCacheSlot *slot = &cache->slots[index];
+  slot->lru_prev = SHIFTCACHE_EMPTY;
+  slot->lru_next = cache->lru_head;
+  if (cache->lru_head != SHIFTCACHE_EMPTY)
+    cache->slots[cache->lru_head].lru_prev = index;
+  else
+    cache->lru_tail = index;
+  cache->lru_head = index;
+}
+
+// --- Helper: Remove a slot from the hash table (backward shift) ---
+static void TableRemove(ShiftCache *cache, uint16_t index) {
+  ShiftCacheSlot *slot = &cache->slots[index];
+  int mask = cache->table_mask;
+  int pos = HashKey(slot->sprite, slot->mask, slot->variant.shift) & mask;
+  while (cache->table[pos] != index)
+    pos = (pos + 1) & mask;
+
+  // Pull later members of the probe run back so lookups never stop early
+  int hole = pos;
+  for (int next = (hole + 1) & mask; cache->table[next] != SHIFTCACHE_EMPTY;
+       next = (next + 1) & mask) {
+    const ShiftCacheSlot *moved = &cache->slots[cache->table[next]];
+    int home =
+        HashKey(moved->sprite, moved->mask, moved->variant.shift) & mask;
+
+    // Move it only if its home is not inside (hole, next]
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      cache->table[hole] = cache->table[next];
+      hole = next;
+    }
+  }
+  cache->table[hole] = SHIFTCACHE_EMPTY;
+}
+
+// --- Helper: Shift every row of (sprite, mask) into a slot ---
+static void BuildVariant(ShiftedSprite *variant, uint32_t *rows,
+                         const Sprite *sprite, const Sprite *mask, int shift) {
+  int src_words = sprite->width_in_words;
+  int words = src_words + 1;
+
+  variant->height = sprite->height;
+  variant->shift = (int16_t)shift;
+  variant->width_in_words = words;
+  variant->rows = rows;
+  variant->spans = Sprite_Spans(mask);
+
+  for (int row = 0; row < sprite->height; row++) {
+    const uint32_t *s_row = Sprite_Ink(sprite) + row * Sprite_RowStride(sprite);
+    const uint32_t *m_row = mask->pixels + row * Sprite_RowStride(mask);
+    uint32_t *m_out = rows + row * words * 2;
+    uint32_t *s_out = m_out + words;
+
+    uint32_t m_carry = 0;
+    uint32_t s_carry = 0;
+    for (int i = 0; i < src_words; i++) {
+      uint32_t m = LoadPixelWord(m_row + i);
+      uint32_t s = LoadPixelWord(s_row + i) & m;
+      m_out[i] = ToMemoryWord(m_carry | (m >> shift));
+      s_out[i] = ToMemoryWord(s_carry | (s >> shift));
+      m_carry = shift ? m << (32 - shift) : 0;
+      s_carry = shift ? s << (32 - shift) : 0;
+    }
+    m_out[src_words] = ToMemoryWord(m_carry);
+    s_out[src_words] = ToMemoryWord(s_carry);
+  }
+}
+
+bool ShiftCache_Init(ShiftCache *cache, SpriteArena *arena,
+                     size_t budget_bytes, size_t slot_bytes) {
+  memset(cache, 0, sizeof(ShiftCache));
+
+  // 1. Slot geometry (the index type leaves 0xFFFF as the empty marker)
+  slot_bytes = (slot_bytes + 63) & ~(size_t)63;
+  size_t slot_count = slot_bytes ? budget_bytes / slot_bytes : 0;
+  if (slot_count == 0)
+    return false;
+  if (slot_count > SHIFTCACHE_EMPTY / 2)
+    slot_count = SHIFTCACHE_EMPTY / 2;
+
+  int table_size = 1;
+  while (table_size < (int)slot_count * 2)
+    table_size <<= 1;
+
+  // 2. Carve everything out of the arena
+  cache->slot_memory =
+      (uint8_t *)Arena_Alloc(arena, slot_count * slot_bytes, 64);
+  cache->slots = (ShiftCacheSlot *)Arena_Alloc(
+      arena, slot_count * sizeof(ShiftCacheSlot), 8);
+  cache->table =
+      (uint16_t *)Arena_Alloc(arena, table_size * sizeof(uint16_t), 4);
+  if (!cache->slot_memory || !cache->slots || !cache->table)
+    return false;
+
+  cache->slot_bytes = slot_bytes;
+  cache->slot_count = (int)slot_count;
+  cache->table_mask = table_size - 1;
+
+  ShiftCache_Clear(cache);
+  return true;
+}
+
+void ShiftCache_Clear(ShiftCache *cache) {
+  memset(cache->table, 0xFF, (cache->table_mask + 1) * sizeof(uint16_t));
+  cache->used_count = 0;
+  cache->lru_head = SHIFTCACHE_EMPTY;
+  cache->lru_tail = SHIFTCACHE_EMPTY;
+}
+
+const ShiftedSprite *ShiftCache_Get(ShiftCache *cache, const Sprite *sprite,
+                                    const Sprite *mask, int shift) {
+  // 1. Lookup
+  int mask_bits = cache->table_mask;
+  int pos = HashKey(sprite, mask, shift) & mask_bits;
+  while (cache->table[pos] != SHIFTCACHE_EMPTY) {
+    uint16_t index = cache->table[pos];
+    if (SlotMatches(&cache->slots[index], sprite, mask, shift)) {
+      cache->hits++;
+      if (cache->lru_head != index) {
+        LruUnlink(cache, index);
+        LruPushFront(cache, index);
+      }
+      return &cache->slots[index].variant;
+    }
+    pos = (pos + 1) & mask_bits;
+  }
+
+  // 2. Miss: does the shifted pair fit in one slot?
+  size_t bytes =
+      (size_t)(sprite->width_in_words + 1) * 2 * 4 * sprite->height;
+  if (bytes > cache->slot_bytes)
+    return nullptr;
+  cache->misses++;
+
+  // 3. Take a free slot, or evict the least recently used one
+  uint16_t index;
+  if (cache->used_count < cache->slot_count) {
+    index = (uint16_t)cache->used_count++;
+  } else {
+    index = cache->lru_tail;
+    LruUnlink(cache, index);
+    TableRemove(cache, index);
+    cache->evictions++;
+
+    // The removal may have moved entries; find the insert position again
+    pos = HashKey(sprite, mask, shift) & mask_bits;
+    while (cache->table[pos] != SHIFTCACHE_EMPTY)
+      pos = (pos + 1) & mask_bits;
+  }
+
+  // 4. Build and publish
+  ShiftCacheSlot *slot = &cache->slots[index];
+  slot->sprite = sprite;
+  slot->mask = mask;
+  BuildVariant(&slot->variant,
+               (uint32_t *)(cache->slot_memory + index * cache->slot_bytes),
+               sprite, mask, shift);
+
+  cache->table[pos] = index;
+  LruPushFront(cache, index);
+  return &slot->variant;
+}
@@ -0,0 +1,74 @@
+#ifndef SHIFTCACHE_H
+#define SHIFTCACHE_H
+
+#include "sprite.h"
+#include "spritearena.h"
+#include <stdint.h>
+
+// Pre-shifted sprite cache.
+// A sprite drawn at an x that is not a multiple of 32 straddles canvas words,
+// so every row of a plain blit shifts and merges two words. This cache keeps
+// copies of (sprite, mask) already shifted right by (x & 31), one word wider,
+// with ink ANDed into the mask and stored in memory order. Drawing a cached
+// variant is then aligned word ANDs / ORs only.
+//
+// Variants are produced lazily on first use into a fixed budget carved out
+// of the SpriteArena once. The budget is split into equal slots; when it is
+// full the least recently used variant is evicted.
+
+typedef struct ShiftedSprite {
+  int16_t height;
+  int16_t shift;          // x & 31 this variant was built for
+  int32_t width_in_words; // Source width_in_words + 1
+
+  // Per row: width_in_words mask words followed by width_in_words ink words
+  const uint32_t *rows;
+
+  // The source mask's span table, or nullptr (see SPRITE_FLAG_SPANS)
+  const SpriteRowSpan *spans;
+} ShiftedSprite;
+
+typedef struct {
+  const Sprite *sprite; // Key (together with mask and shift)
+  const Sprite *mask;
+  ShiftedSprite variant;
+  uint16_t lru_prev;
+  uint16_t lru_next;
+} ShiftCacheSlot;
+
+typedef struct ShiftCache {
+  ShiftCacheSlot *slots;
+  uint8_t *slot_memory;
+  size_t slot_bytes;
+  int slot_count;
+
+  uint16_t *table; // Open addressing, slot index or SHIFTCACHE_EMPTY
+  int table_mask;
+
+  int used_count;
+  uint16_t lru_head; // Most recently used
+  uint16_t lru_tail; // Least recently used, evicted first
+
+  // Stats
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+} ShiftCache;
+
+#define SHIFTCACHE_EMPTY 0xFFFF
+
+// Carves budget_bytes (plus bookkeeping) out of the arena. Sprites whose
+// shifted copy does not fit in slot_bytes are never cached.
+// Returns false if the arena is out of memory.
+bool ShiftCache_Init(ShiftCache *cache, SpriteArena *arena,
+                     size_t budget_bytes, size_t slot_bytes);
+
+// Returns the variant of (sprite, mask) for x & 31, building it on a miss.
+// Returns nullptr if the pair cannot be cached (too large for a slot).
+const ShiftedSprite *ShiftCache_Get(ShiftCache *cache, const Sprite *sprite,
+                                    const Sprite *mask, int shift);
+
+// Drops every variant, e.g. after sprite pixels were changed in place.
+void ShiftCache_Clear(ShiftCache *cache);
+
+#endif // SHIFTCACHE_H
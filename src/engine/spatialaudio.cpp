@@ -0,0 +1,72 @@
+#include "spatialaudio.h"
+#include "arena.h"
+#include "audio.h"
+#include "ecs.h"
+#include "engine.h"
+#include <cmath>
+
+// Smaller changes in volume or pan are not worth a mixer command
+#define SPATIAL_AUDIO_EPSILON (1.0f / 256.0f)
+
+// --- Helper: Volume and pan of one emitter at the listener ---
+static void Spatialize(const AudioListener &listener, float x, float y,
+                       float volume, float *out_volume, float *out_pan) {
+  float dx = x - listener.x;
+  float dy = y - listener.y;
+  float distance = sqrtf(dx * dx + dy * dy);
+
+  float gain = listener.range > 0 ? 1.0f - distance / listener.range : 1.0f;
+  *out_volume = gain > 0 ? volume * gain : 0.0f;
+
+  float pan = listener.pan_width > 0 ? dx / listener.pan_width : 0.0f;
+  *out_pan = pan < -1.0f ? -1.0f : (pan > 1.0f ? 1.0f : pan);
+}
+
+void UpdateAudioEmitters(Registry &registry, Engine &engine,
+                         const AudioListener &listener) {
+  AudioEmitterComponent *emitters = registry.audio_emitters_data();
+  int count = registry.audio_emitters_count();
+  if (count == 0)
+    return;
+
+  // 1. Collect the emitters that moved, with their index for the write-back
+  VoiceParams *params = (VoiceParams *)Arena_Alloc(
+      engine.frame_arena(), sizeof(VoiceParams) * count, alignof(VoiceParams));
+  int *sources =
+      (int *)Arena_Alloc(engine.frame_arena(), sizeof(int) * count, 0);
+  if (!params || !sources)
+    return;
+
+  int changed = 0;
+  for (int i = 0; i < count; i++) {
+    AudioEmitterComponent &e = emitters[i];
+    if (!e.voice)
+      continue;
+
+    DisplaceableComponent *position = registry.get_displaceable(e.owner);
+    if (!position)
+      continue;
+
+    float volume, pan;
+    Spatialize(listener, position->x, position->y, e.volume, &volume, &pan);
+    if (fabsf(volume - e.sent_volume) < SPATIAL_AUDIO_EPSILON &&
+        fabsf(pan - e.sent_pan) < SPATIAL_AUDIO_EPSILON)
+      continue;
+
+    e.sent_volume = volume;
+    e.sent_pan = pan;
+    params[changed] = {e.voice, volume, pan};
+    sources[changed] = i;
+    changed++;
+  }
+
+  if (changed == 0)
+    return;
+
+  // 2. One call for the whole batch; ended voices come back as 0
+  engine.set_sound_params(params, changed);
+  for (int i = 0; i < changed; i++) {
+    if (!params[i].voice)
+      emitters[sources[i]].voice = 0;
+  }
+}
@@ -0,0 +1,22 @@
+#ifndef SPATIALAUDIO_H
+#define SPATIALAUDIO_H
+
+class Registry;
+class Engine;
+
+// Where the game hears from, in canvas coordinates.
+typedef struct {
+  float x, y;
+  float range;     // Emitters at this distance or beyond are silent
+  float pan_width; // Horizontal offset that pans a sound fully to one side
+} AudioListener;
+
+// The spatial audio system. Walks the dense AudioEmitterComponent array
+// once, turns each owner's position (its DisplaceableComponent) into a
+// volume and pan relative to 'listener', and sends only the emitters whose
+// volume or pan moved to the mixer, all in a single batch. Emitters whose
+// voice has ended are left with voice 0 for the game to reuse or remove.
+void UpdateAudioEmitters(Registry &registry, Engine &engine,
+                         const AudioListener &listener);
+
+#endif // SPATIALAUDIO_H
@@ -15,11 +15,92 @@ typedef struct __attribute__((aligned(4))) Sprite {
   // Used for your word-loops so you don't divide at runtime.
   int32_t width_in_words;
 
-  // 3. The Data
+  // 3. Optional extras stored after the pixels (SPRITE_FLAG_*)
+  uint32_t flags;
+
+  // 4. The Data
   // We use a "Flexible Array Member" (C99 feature).
   // The data sits *inside* the struct allocation, not a pointer to elsewhere.
   // This reduces cache misses (1 fetch for struct + data).
   uint32_t pixels[];
 } Sprite;
 
+// The sprite carries a span table (one SpriteRowSpan per row) right after
+// its pixels. Set by the loaders on request; used when the sprite is a mask.
+#define SPRITE_FLAG_SPANS (1 << 0)
+
+// The sprite's mask is stored right after it, in the same allocation (see
+// Sprite_Mask). Set by LoadMaskedSpritePBM.
+#define SPRITE_FLAG_MASKED (1 << 1)
+
+// The attached mask was generated as an outline rather than a silhouette.
+// Only needed to build it the same way again (hot reload).
+#define SPRITE_FLAG_MASK_OUTLINE (1 << 2)
+
+// Packed masked sprite: every row holds width_in_words mask words followed
+// by width_in_words ink words, so the blitter streams both from one place.
+// The sprite is its own mask (mask planes come first, so mask readers only
+// need Sprite_RowStride). Set by LoadInterleavedSpritePBM.
+#define SPRITE_FLAG_INTERLEAVED (1 << 3)
+
+// Row is fully opaque between first_word and end_word
+#define SPAN_FLAG_OPAQUE (1 << 0)
+
+// Words of a mask row that contain any opaque pixel. Rows without any have
+// first_word == end_word, so the blitter skips them outright.
+typedef struct {
+  int16_t first_word;
+  int16_t end_word; // One past the last covered word
+  uint16_t flags;   // SPAN_FLAG_OPAQUE
+  uint16_t _padding;
+} SpriteRowSpan;
+
+// Words from one row to the next: one plane, or mask and ink interleaved
+static inline int32_t Sprite_RowStride(const Sprite *s) {
+  return (s->flags & SPRITE_FLAG_INTERLEAVED) ? s->width_in_words * 2
+                                              : s->width_in_words;
+}
+
+// First row of the ink plane. Mask planes always start at 'pixels'.
+static inline const uint32_t *Sprite_Ink(const Sprite *s) {
+  return (s->flags & SPRITE_FLAG_INTERLEAVED) ? s->pixels + s->width_in_words
+                                              : s->pixels;
+}
+
+// Returns the span table of 's', or nullptr if it was loaded without one.
+static inline const SpriteRowSpan *Sprite_Spans(const Sprite *s) {
+  if (!(s->flags & SPRITE_FLAG_SPANS))
+    return nullptr;
+  return (const SpriteRowSpan *)(s->pixels + Sprite_RowStride(s) * s->height);
+}
+
+// Bytes to reserve after the pixels of a 'height' rows sprite for its spans
+static inline size_t Sprite_SpansBytes(int height) {
+  return (size_t)height * sizeof(SpriteRowSpan);
+}
+
+// Bytes of 's' itself: header, pixels and span table, if any
+static inline size_t Sprite_Bytes(const Sprite *s) {
+  size_t bytes = sizeof(Sprite) + (size_t)Sprite_RowStride(s) * 4 * s->height;
+  if (s->flags & SPRITE_FLAG_SPANS)
+    bytes += Sprite_SpansBytes(s->height);
+  return bytes;
+}
+
+// The mask to draw 's' through: the attached one, or else 's' itself (a
+// sprite without a mask paints only its ink).
+static inline Sprite *Sprite_Mask(const Sprite *s) {
+  if (!(s->flags & SPRITE_FLAG_MASKED))
+    return (Sprite *)s;
+  return (Sprite *)((const uint8_t *)s + Sprite_Bytes(s));
+}
+
+// Bytes of 's' including its attached mask, i.e. what to copy to move it
+static inline size_t Sprite_TotalBytes(const Sprite *s) {
+  size_t bytes = Sprite_Bytes(s);
+  if (s->flags & SPRITE_FLAG_MASKED)
+    bytes += Sprite_Bytes(Sprite_Mask(s));
+  return bytes;
+}
+
 #endif
\ No newline at end of file
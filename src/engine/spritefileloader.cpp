@@ -1,125 +1,405 @@
 #include "spritefileloader.h"
+#include "pbm.h"
+#include "pixelword.h"
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <fstream>
 #include <iostream>
-#include <limits>
-#include <string>
-
-// --- Helper: Skip Comments & Whitespace (Duplicated from bkgimageloader) ---
-static void skip_comments(std::ifstream &fs) {
-  char ch;
-  while (fs.get(ch)) {
-    if (std::isspace(ch)) {
-      continue;
+
+void BuildSpriteSpans(Sprite *s) {
+  int32_t stride = Sprite_RowStride(s);
+  SpriteRowSpan *spans = (SpriteRowSpan *)(s->pixels + stride * s->height);
+
+  for (int y = 0; y < s->height; y++) {
+    const uint32_t *row = s->pixels + y * stride;
+    int first = 0;
+    int end = s->width_in_words;
+
+    while (first < end && row[first] == 0)
+      first++;
+    while (end > first && row[end - 1] == 0)
+      end--;
+
+    bool opaque = (first < end);
+    for (int i = first; i < end && opaque; i++)
+      opaque = (row[i] == 0xFFFFFFFFu);
+
+    spans[y].first_word = (int16_t)first;
+    spans[y].end_word = (int16_t)end;
+    spans[y].flags = opaque ? SPAN_FLAG_OPAQUE : 0;
+    spans[y]._padding = 0;
+  }
+
+  s->flags |= SPRITE_FLAG_SPANS;
+}
+
+// --- Helper: Decode the image at the cursor, optionally with span table ---
+static Sprite *ReadSprite(SpriteArena *arena, PBMFile *file, bool with_spans) {
+  // 1. Parse the header
+  PBMImage image;
+  if (!PBM_ReadHeader(file, &image))
+    return nullptr;
+
+  // 2. Calculate Allocation Size
+  // Rows are padded to whole words; the padding bits are transparent.
+  size_t total_data_bytes = (size_t)image.width_in_words * 4 * image.height;
+  size_t span_bytes = with_spans ? Sprite_SpansBytes(image.height) : 0;
+
+  // 3. Allocate from Arena
+  Sprite *s = (Sprite *)Arena_Alloc(
+      arena, sizeof(Sprite) + total_data_bytes + span_bytes, 4);
+  if (!s)
+    return nullptr;
+
+  // 4. Fill Metadata
+  s->width = (int16_t)image.width;
+  s->height = (int16_t)image.height;
+  s->width_in_words = image.width_in_words;
+  s->flags = 0;
+
+  // 5. Decode the Bits
+  if (!PBM_ReadRaster(file, &image, s->pixels))
+    return nullptr;
+
+  // 6. Optional span table, from the bits we just read
+  if (with_spans)
+    BuildSpriteSpans(s);
+
+  return s;
+}
+
+static Sprite *LoadPBM(SpriteArena *arena, const char *filename,
+                       bool with_spans) {
+  PBMFile file;
+  if (!PBM_Open(&file, filename))
+    return nullptr;
+
+  Sprite *s = ReadSprite(arena, &file, with_spans);
+  PBM_Close(&file);
+  return s;
+}
+
+Sprite *LoadSpritePBM(SpriteArena *arena, const char *filename) {
+  return LoadPBM(arena, filename, false);
+}
+
+Sprite *LoadSpritePBMWithSpans(SpriteArena *arena, const char *filename) {
+  return LoadPBM(arena, filename, true);
+}
+
+int LoadSpriteSheetPBM(SpriteArena *arena, const char *filename,
+                       Sprite **sprites, int max_sprites, bool with_spans) {
+  PBMFile file;
+  if (!PBM_Open(&file, filename))
+    return 0;
+
+  int count = 0;
+  while (count < max_sprites && PBM_HasImage(&file)) {
+    Sprite *s = ReadSprite(arena, &file, with_spans);
+    if (!s)
+      break;
+    sprites[count++] = s;
+  }
+
+  if (count == max_sprites && PBM_HasImage(&file)) {
+    std::cerr << "Warning: Sprite sheet " << filename << " holds more than "
+              << max_sprites << " images" << std::endl;
+  }
+
+  PBM_Close(&file);
+  return count;
+}
+
+// --- Helper: Valid pixel bits of each word of a 'width' pixels row ---
+// Pixel words (see pixelword.h): the padding past 'width' is never opaque.
+static inline uint32_t ValidBits(int width, int word) {
+  int remaining = width - word * 32;
+  return remaining >= 32 ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> remaining);
+}
+
+// --- Helper: Grow 'row' sideways through 'allowed' until it stops changing ---
+static bool SpreadRow(uint32_t *row, const uint32_t *allowed, int words) {
+  bool grew = false;
+  bool again = true;
+  while (again) {
+    again = false;
+    for (int i = 0; i < words; i++) {
+      uint32_t from_left = i > 0 ? row[i - 1] << 31 : 0;
+      uint32_t from_right = i + 1 < words ? row[i + 1] >> 31 : 0;
+      uint32_t next =
+          (row[i] | (row[i] >> 1) | (row[i] << 1) | from_left | from_right) &
+          allowed[i];
+      if (next != row[i]) {
+        row[i] = next;
+        again = grew = true;
+      }
     }
-    if (ch == '#') {
-      fs.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-      continue;
+  }
+  return grew;
+}
+
+// --- Helper: Grow 'row' into the rows above / below it ---
+static bool SpreadFromRow(uint32_t *row, const uint32_t *neighbour,
+                          const uint32_t *allowed, int words) {
+  bool grew = false;
+  for (int i = 0; i < words; i++) {
+    uint32_t next = row[i] | (neighbour[i] & allowed[i]);
+    if (next != row[i]) {
+      row[i] = next;
+      grew = true;
     }
-    fs.unget();
-    break;
   }
+  return grew;
 }
 
-// --- Helper: Arena Allocator for SpriteArena ---
-static void *Arena_Alloc(SpriteArena *arena, size_t size, size_t align) {
-  // 1. Calculate current address
-  uintptr_t current_ptr = (uintptr_t)(arena->base_memory + arena->bytes_used);
+void BuildSpriteMask(const Sprite *sprite, Sprite *mask, uint32_t mask_mode) {
+  int width = sprite->width;
+  int height = sprite->height;
+  int words = sprite->width_in_words;
+  size_t count = (size_t)words * height;
+
+  mask->width = sprite->width;
+  mask->height = sprite->height;
+  mask->width_in_words = words;
+  mask->flags = 0;
 
-  // 2. Calculate alignment offset
-  size_t offset = 0;
-  if (align > 0) {
-    size_t modulo = current_ptr % align;
-    if (modulo != 0) {
-      offset = align - modulo;
+  // Scratch: paper (may be flooded) and outside (flooded so far), in pixel
+  // words so neighbours are plain shifts
+  uint32_t *paper = (uint32_t *)malloc(count * 2 * sizeof(uint32_t));
+  if (!paper) {
+    // Fall back to the ink alone rather than failing the load
+    memcpy(mask->pixels, sprite->pixels, count * sizeof(uint32_t));
+    return;
+  }
+  uint32_t *outside = paper + count;
+
+  // 1. Seed the flood with the paper on the sprite's edges
+  for (int y = 0; y < height; y++) {
+    for (int i = 0; i < words; i++) {
+      size_t k = (size_t)y * words + i;
+      paper[k] = ~LoadPixelWord(sprite->pixels + k) & ValidBits(width, i);
+
+      uint32_t edge = 0;
+      if (y == 0 || y == height - 1)
+        edge = 0xFFFFFFFFu;
+      if (i == 0)
+        edge |= 0x80000000u;
+      if (i == words - 1)
+        edge |= 0x80000000u >> ((width - 1) & 31);
+      outside[k] = paper[k] & edge;
     }
   }
 
-  // 3. Check capacity
-  if (arena->bytes_used + offset + size > arena->capacity) {
-    std::cerr << "Error: SpriteArena out of memory!" << std::endl;
-    return nullptr;
+  // 2. Flood: sweep down and up, spreading sideways in every row, until a
+  // full round adds nothing (a few rounds unless the paper spirals)
+  bool grew = true;
+  while (grew) {
+    grew = false;
+    for (int y = 0; y < height; y++) {
+      uint32_t *row = outside + (size_t)y * words;
+      const uint32_t *allowed = paper + (size_t)y * words;
+      if (y > 0)
+        grew |= SpreadFromRow(row, row - words, allowed, words);
+      grew |= SpreadRow(row, allowed, words);
+    }
+    for (int y = height - 2; y >= 0; y--) {
+      uint32_t *row = outside + (size_t)y * words;
+      const uint32_t *allowed = paper + (size_t)y * words;
+      grew |= SpreadFromRow(row, row + words, allowed, words);
+      grew |= SpreadRow(row, allowed, words);
+    }
   }
 
-  // 4. Update usage and return aligned pointer
-  arena->bytes_used += offset;
-  void *result = arena->base_memory + arena->bytes_used;
-  arena->bytes_used += size;
+  // 3. Silhouette: everything the outside did not reach
+  uint32_t *solid = paper; // Paper is no longer needed
+  for (int y = 0; y < height; y++) {
+    for (int i = 0; i < words; i++) {
+      size_t k = (size_t)y * words + i;
+      solid[k] = ~outside[k] & ValidBits(width, i);
+    }
+  }
+
+  // 4. Outline: grow the silhouette by one pixel in all eight directions
+  if (mask_mode == SPRITE_MASK_OUTLINE) {
+    for (int y = 0; y < height; y++) {
+      uint32_t *row = solid + (size_t)y * words;
+      uint32_t *wide = outside + (size_t)y * words;
+      for (int i = 0; i < words; i++) {
+        uint32_t from_left = i > 0 ? row[i - 1] << 31 : 0;
+        uint32_t from_right = i + 1 < words ? row[i + 1] >> 31 : 0;
+        wide[i] = row[i] | (row[i] >> 1) | (row[i] << 1) | from_left |
+                  from_right;
+      }
+    }
+    for (int y = 0; y < height; y++) {
+      for (int i = 0; i < words; i++) {
+        size_t k = (size_t)y * words + i;
+        uint32_t bits = outside[k];
+        if (y > 0)
+          bits |= outside[k - words];
+        if (y + 1 < height)
+          bits |= outside[k + words];
+        mask->pixels[k] = ToMemoryWord(bits & ValidBits(width, i));
+      }
+    }
+  } else {
+    for (size_t k = 0; k < count; k++)
+      mask->pixels[k] = ToMemoryWord(solid[k]);
+  }
 
-  return result;
+  free(paper);
 }
 
-Sprite *LoadSpritePBM(SpriteArena *arena, const char *filename) {
-  std::ifstream fs(filename, std::ios::binary);
-  if (!fs) {
-    std::cerr << "Error: Could not open file " << filename << std::endl;
-    return nullptr;
+// --- Helper: Read the next image of 'file' as the mask of 'sprite' ---
+static bool ReadMaskImage(PBMFile *file, const Sprite *sprite, Sprite *mask) {
+  PBMImage image;
+  if (!PBM_ReadHeader(file, &image))
+    return false;
+  if (image.width != sprite->width || image.height != sprite->height) {
+    std::cerr << "Error: Mask in " << file->filename
+              << " does not match the size of its sprite" << std::endl;
+    return false;
   }
 
-  // 1. Check Magic Number (Must be "P4")
-  std::string line;
-  if (!std::getline(fs, line) || line.length() < 2 || line[0] != 'P' ||
-      line[1] != '4') {
-    std::cerr << "Error: Invalid PBM format in " << filename << " (Expected P4)"
-              << std::endl;
-    return nullptr;
-  }
+  mask->width = sprite->width;
+  mask->height = sprite->height;
+  mask->width_in_words = sprite->width_in_words;
+  mask->flags = 0;
+  return PBM_ReadRaster(file, &image, mask->pixels);
+}
 
-  // 2. Parse Dimensions
-  int width, height;
+// --- Helper: "<name>.pbm" -> "<name>.mask.pbm", if that file exists ---
+static bool FindPairedMask(const char *filename, char *out, size_t out_size) {
+  size_t length = strlen(filename);
+  if (length > 4 && strcmp(filename + length - 4, ".pbm") == 0)
+    length -= 4;
+  if (snprintf(out, out_size, "%.*s.mask.pbm", (int)length, filename) >=
+      (int)out_size)
+    return false;
 
-  skip_comments(fs);
-  if (!(fs >> width))
-    return nullptr;
+  FILE *fp = fopen(out, "rb");
+  if (!fp)
+    return false;
+  fclose(fp);
+  return true;
+}
 
-  skip_comments(fs);
-  if (!(fs >> height))
-    return nullptr;
+// --- Helper: Sprite and mask one after the other, as LoadMaskedSpritePBM ---
+static size_t MaskedBlockBytes(const PBMImage *image) {
+  size_t sprite_bytes =
+      sizeof(Sprite) + (size_t)image->width_in_words * 4 * image->height;
+  return sprite_bytes * 2 + Sprite_SpansBytes(image->height);
+}
+
+// --- Helper: Decode the sprite at the cursor and find or build its mask ---
+// 'block' has MaskedBlockBytes(image) bytes.
+static Sprite *ReadMaskedSprite(PBMFile *file, const PBMImage *image,
+                                uint32_t mask_mode, uint8_t *block) {
+  size_t sprite_bytes =
+      sizeof(Sprite) + (size_t)image->width_in_words * 4 * image->height;
+  Sprite *s = (Sprite *)block;
+  Sprite *mask = (Sprite *)(block + sprite_bytes);
+  s->width = (int16_t)image->width;
+  s->height = (int16_t)image->height;
+  s->width_in_words = image->width_in_words;
+  s->flags = 0;
 
-  // 3. Enforce Mechanical Sympathy (The 32-pixel rule)
-  // Essential for our 32-bit word processing loop
-  if (width % 32 != 0) {
-    std::cerr << "Error: Sprite " << filename << " width (" << width
-              << ") is not a multiple of 32." << std::endl;
+  if (!PBM_ReadRaster(file, image, s->pixels))
     return nullptr;
+
+  // 1. Embedded plane, paired file, or generated
+  bool have_mask = false;
+  if (PBM_HasImage(file)) {
+    have_mask = ReadMaskImage(file, s, mask);
+  } else {
+    char mask_path[512];
+    if (FindPairedMask(file->filename, mask_path, sizeof(mask_path))) {
+      PBMFile mask_file;
+      if (PBM_Open(&mask_file, mask_path)) {
+        have_mask = ReadMaskImage(&mask_file, s, mask);
+        PBM_Close(&mask_file);
+      }
+    }
   }
 
-  // 4. Consume the single whitespace byte after the header
-  char ch;
-  if (fs.get(ch) && !std::isspace(ch)) {
-    fs.unget();
+  if (!have_mask) {
+    BuildSpriteMask(s, mask, mask_mode);
+    if (mask_mode == SPRITE_MASK_OUTLINE)
+      s->flags |= SPRITE_FLAG_MASK_OUTLINE;
   }
 
-  // 5. Calculate Allocation Size
-  int32_t words_per_row = width / 32;
-  int32_t bytes_per_row = words_per_row * 4;
-  size_t total_data_bytes = bytes_per_row * height;
+  // 2. The mask is what the blitter walks, so it carries the spans
+  BuildSpriteSpans(mask);
+  s->flags |= SPRITE_FLAG_MASKED;
+  return s;
+}
+
+Sprite *LoadMaskedSpritePBM(SpriteArena *arena, const char *filename,
+                            uint32_t mask_mode) {
+  PBMFile file;
+  if (!PBM_Open(&file, filename))
+    return nullptr;
+
+  // One block: sprite, then the mask and its span table
+  Sprite *s = nullptr;
+  PBMImage image;
+  if (PBM_ReadHeader(&file, &image)) {
+    uint8_t *block =
+        (uint8_t *)Arena_Alloc(arena, MaskedBlockBytes(&image), 4);
+    if (block)
+      s = ReadMaskedSprite(&file, &image, mask_mode, block);
+  }
 
-  // 6. Allocate from Arena
-  // Sprite struct has __attribute__((aligned(4))), but we can align to 4 bytes
-  // or more.
-  Sprite *s =
-      (Sprite *)Arena_Alloc(arena, sizeof(Sprite) + total_data_bytes, 4);
+  PBM_Close(&file);
+  return s;
+}
+
+Sprite *LoadInterleavedSpritePBM(SpriteArena *arena, const char *filename,
+                                 uint32_t mask_mode) {
+  PBMFile file;
+  if (!PBM_Open(&file, filename))
+    return nullptr;
 
-  if (!s) {
+  PBMImage image;
+  if (!PBM_ReadHeader(&file, &image)) {
+    PBM_Close(&file);
     return nullptr;
   }
 
-  // 7. Fill Metadata
-  s->width = (int16_t)width;
-  s->height = (int16_t)height;
-  s->width_in_words = words_per_row;
+  // 1. Load the two planes side by side into temporary memory
+  uint8_t *planes = (uint8_t *)malloc(MaskedBlockBytes(&image));
+  Sprite *masked = planes ? ReadMaskedSprite(&file, &image, mask_mode, planes)
+                          : nullptr;
+  PBM_Close(&file);
 
-  // 8. Read the Bits
-  fs.read((char *)s->pixels, total_data_bytes);
+  // 2. Weave them together row by row, then copy the mask's spans
+  Sprite *s = nullptr;
+  if (masked) {
+    int words = masked->width_in_words;
+    size_t pixel_bytes = (size_t)words * 4 * 2 * masked->height;
+    s = (Sprite *)Arena_Alloc(arena,
+                              sizeof(Sprite) + pixel_bytes +
+                                  Sprite_SpansBytes(masked->height),
+                              4);
+    if (s) {
+      const Sprite *mask = Sprite_Mask(masked);
+      s->width = masked->width;
+      s->height = masked->height;
+      s->width_in_words = words;
+      s->flags = SPRITE_FLAG_INTERLEAVED | SPRITE_FLAG_SPANS |
+                 (masked->flags & SPRITE_FLAG_MASK_OUTLINE);
 
-  if (!fs) {
-    if (fs.gcount() != (std::streamsize)total_data_bytes) {
-      std::cerr << "Warning: File " << filename << " ended early (Corrupt?)"
-                << std::endl;
+      for (int y = 0; y < s->height; y++) {
+        uint32_t *row = s->pixels + (size_t)y * words * 2;
+        memcpy(row, mask->pixels + (size_t)y * words, words * 4);
+        memcpy(row + words, masked->pixels + (size_t)y * words, words * 4);
+      }
+      memcpy((void *)Sprite_Spans(s), Sprite_Spans(mask),
+             Sprite_SpansBytes(s->height));
     }
   }
 
+  free(planes);
   return s;
 }
@@ -4,9 +4,50 @@
 #include "sprite.h"
 #include "spritearena.h"
 
-// Loads a PBM file (P4, raw bits) into a new Sprite allocated from the provided
-// arena. Returns nullptr on failure (file not found, format error, out of
-// memory).
+// Loads a PBM file (P4 or P1, any width, see pbm.h) into a new Sprite
+// allocated from the provided arena. Returns nullptr on failure (file not
+// found, format error, out of memory).
 Sprite *LoadSpritePBM(SpriteArena *arena, const char *filename);
 
+// Same as LoadSpritePBM, but also stores a per-row span table right after the
+// pixels (SPRITE_FLAG_SPANS). Use it for masks, mostly transparent ones in
+// particular: the blitter then only visits covered words.
+Sprite *LoadSpritePBMWithSpans(SpriteArena *arena, const char *filename);
+
+// Loads every image of a multi-image PBM file (a sprite sheet) into
+// 'sprites', in file order, in a single pass. Returns how many were loaded;
+// stops at the first bad image or after max_sprites.
+int LoadSpriteSheetPBM(SpriteArena *arena, const char *filename,
+                       Sprite **sprites, int max_sprites, bool with_spans);
+
+// How LoadMaskedSpritePBM builds a mask when the file does not come with one
+#define SPRITE_MASK_SILHOUETTE 0 // Ink plus the paper it encloses
+#define SPRITE_MASK_OUTLINE 1    // Silhouette grown by one pixel (paper rim)
+
+// Loads a sprite together with its mask. The mask is, in order of preference:
+//   1. a second image of the same size in the same file (embedded plane)
+//   2. a paired file next to it, "<name>.mask.pbm" for "<name>.pbm"
+//   3. generated from the ink according to mask_mode
+// Both are stored in one allocation, the mask (with a span table) right after
+// the sprite; Sprite_Mask returns it. Returns the sprite, or nullptr on
+// failure.
+Sprite *LoadMaskedSpritePBM(SpriteArena *arena, const char *filename,
+                            uint32_t mask_mode);
+
+// Same sources as LoadMaskedSpritePBM, but stores the result in the packed
+// format (SPRITE_FLAG_INTERLEAVED): each row is the mask words followed by
+// the ink words, so drawing it touches one stream instead of two. The
+// sprite is its own mask; draw it with mask == sprite.
+Sprite *LoadInterleavedSpritePBM(SpriteArena *arena, const char *filename,
+                                 uint32_t mask_mode);
+
+// Fills 'mask' (same size as 'sprite', no span table yet) from the sprite's
+// ink. A silhouette keeps the enclosed paper opaque, so only the paper
+// connected to the sprite's edges is transparent.
+void BuildSpriteMask(const Sprite *sprite, Sprite *mask, uint32_t mask_mode);
+
+// Computes the span table of 's' in place. The caller must have reserved
+// Sprite_SpansBytes(s->height) bytes right after the pixels.
+void BuildSpriteSpans(Sprite *s);
+
 #endif // SPRITEASSETLOADER_H
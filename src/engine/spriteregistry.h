@@ -0,0 +1,10 @@
+#ifndef SPRITEREGISTRY_H
+#define SPRITEREGISTRY_H
+
+#include "assetregistry.h"
+#include "sprite.h"
+
+// Sprites by name, e.g. "player_idle" or the path they were loaded from.
+typedef AssetRegistry<Sprite> SpriteRegistry;
+
+#endif // SPRITEREGISTRY_H
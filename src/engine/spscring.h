@@ -0,0 +1,64 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <stdint.h>
+
+// Lock-free single-producer single-consumer ring of fixed capacity.
+// One thread pushes and one other thread pops; neither ever blocks or takes
+// a lock, so either end may live in the audio callback. The producer only
+// writes 'tail' and the consumer only writes 'head'; each publishes its
+// side with a release store that the other side reads with an acquire
+// load, which also makes the item itself visible. The indices run freely
+// and are wrapped with the (power of two) capacity.
+
+template <typename T, uint32_t N> struct SPSCRing {
+  static_assert((N & (N - 1)) == 0, "SPSCRing size must be a power of two");
+
+  // Padded apart so the two threads do not share a cache line (without
+  // over-aligning the struct, which plain C++11 'new' cannot honour)
+  uint32_t head; // Next item to pop (consumer)
+  uint8_t _padding[64 - sizeof(uint32_t)];
+  uint32_t tail; // Next free slot (producer)
+  T items[N];
+};
+
+template <typename T, uint32_t N>
+inline void SPSCRing_Init(SPSCRing<T, N> *ring) {
+  ring->head = 0;
+  ring->tail = 0;
+}
+
+// Producer. Returns false (and drops nothing) if the ring is full.
+template <typename T, uint32_t N>
+inline bool SPSCRing_Push(SPSCRing<T, N> *ring, const T *item) {
+  uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  if (tail - head == N)
+    return false;
+
+  ring->items[tail & (N - 1)] = *item;
+  __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+// Consumer. Returns false if the ring is empty.
+template <typename T, uint32_t N>
+inline bool SPSCRing_Pop(SPSCRing<T, N> *ring, T *item) {
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+  uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  if (head == tail)
+    return false;
+
+  *item = ring->items[head & (N - 1)];
+  __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+// Either side: true once the consumer has taken everything pushed so far.
+template <typename T, uint32_t N>
+inline bool SPSCRing_IsEmpty(const SPSCRing<T, N> *ring) {
+  return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) ==
+         __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+#endif // SPSCRING_H
@@ -0,0 +1,156 @@
+#include "thread.h"
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#endif
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION NativeMutex;
+typedef HANDLE NativeSemaphore;
+typedef HANDLE NativeThread;
+#else
+typedef pthread_mutex_t NativeMutex;
+typedef sem_t NativeSemaphore;
+typedef pthread_t NativeThread;
+#endif
+
+static_assert(sizeof(NativeMutex) <= sizeof(Mutex::storage),
+              "Mutex storage too small");
+static_assert(sizeof(NativeSemaphore) <= sizeof(Semaphore::storage),
+              "Semaphore storage too small");
+static_assert(sizeof(NativeThread) <= sizeof(Thread::storage),
+              "Thread storage too small");
+
+// --- Helper: Start record handed to the new thread ---
+typedef struct {
+  ThreadFunction function;
+  void *user_data;
+} ThreadStart;
+
+#ifdef _WIN32
+static DWORD WINAPI ThreadEntry(LPVOID param) {
+#else
+static void *ThreadEntry(void *param) {
+#endif
+  ThreadStart start = *(ThreadStart *)param;
+  delete (ThreadStart *)param;
+  start.function(start.user_data);
+  return 0;
+}
+
+void Mutex_Init(Mutex *mutex) {
+#ifdef _WIN32
+  InitializeCriticalSection((NativeMutex *)mutex->storage);
+#else
+  pthread_mutex_init((NativeMutex *)mutex->storage, nullptr);
+#endif
+}
+
+void Mutex_Destroy(Mutex *mutex) {
+#ifdef _WIN32
+  DeleteCriticalSection((NativeMutex *)mutex->storage);
+#else
+  pthread_mutex_destroy((NativeMutex *)mutex->storage);
+#endif
+}
+
+void Mutex_Lock(Mutex *mutex) {
+#ifdef _WIN32
+  EnterCriticalSection((NativeMutex *)mutex->storage);
+#else
+  pthread_mutex_lock((NativeMutex *)mutex->storage);
+#endif
+}
+
+void Mutex_Unlock(Mutex *mutex) {
+#ifdef _WIN32
+  LeaveCriticalSection((NativeMutex *)mutex->storage);
+#else
+  pthread_mutex_unlock((NativeMutex *)mutex->storage);
+#endif
+}
+
+void Semaphore_Init(Semaphore *semaphore, int initial_count) {
+#ifdef _WIN32
+  *(NativeSemaphore *)semaphore->storage =
+      CreateSemaphoreA(NULL, initial_count, 0x7FFFFFFF, NULL);
+#else
+  sem_init((NativeSemaphore *)semaphore->storage, 0, initial_count);
+#endif
+}
+
+void Semaphore_Destroy(Semaphore *semaphore) {
+#ifdef _WIN32
+  CloseHandle(*(NativeSemaphore *)semaphore->storage);
+#else
+  sem_destroy((NativeSemaphore *)semaphore->storage);
+#endif
+}
+
+void Semaphore_Wait(Semaphore *semaphore) {
+#ifdef _WIN32
+  WaitForSingleObject(*(NativeSemaphore *)semaphore->storage, INFINITE);
+#else
+  // Retry if a signal interrupts the wait
+  while (sem_wait((NativeSemaphore *)semaphore->storage) != 0) {
+  }
+#endif
+}
+
+void Semaphore_Post(Semaphore *semaphore) {
+#ifdef _WIN32
+  ReleaseSemaphore(*(NativeSemaphore *)semaphore->storage, 1, NULL);
+#else
+  sem_post((NativeSemaphore *)semaphore->storage);
+#endif
+}
+
+bool Thread_Create(Thread *thread, ThreadFunction function, void *user_data) {
+  ThreadStart *start = new (std::nothrow) ThreadStart;
+  if (!start)
+    return false;
+  start->function = function;
+  start->user_data = user_data;
+
+#ifdef _WIN32
+  HANDLE handle = CreateThread(NULL, 0, ThreadEntry, start, 0, NULL);
+  if (!handle) {
+    delete start;
+    return false;
+  }
+  *(NativeThread *)thread->storage = handle;
+#else
+  if (pthread_create((NativeThread *)thread->storage, nullptr, ThreadEntry,
+                     start) != 0) {
+    delete start;
+    return false;
+  }
+#endif
+  return true;
+}
+
+void Thread_Join(Thread *thread) {
+#ifdef _WIN32
+  HANDLE handle = *(NativeThread *)thread->storage;
+  WaitForSingleObject(handle, INFINITE);
+  CloseHandle(handle);
+#else
+  pthread_join(*(NativeThread *)thread->storage, nullptr);
+#endif
+}
+
+void Thread_Sleep(uint32_t ms) {
+#ifdef _WIN32
+  Sleep(ms);
+#else
+  struct timespec duration;
+  duration.tv_sec = ms / 1000;
+  duration.tv_nsec = (long)(ms % 1000) * 1000000L;
+  nanosleep(&duration, nullptr);
+#endif
+}
@@ -0,0 +1,55 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <stdint.h>
+
+// Minimal threading shim over pthreads and Win32.
+// The MinGW win32 thread model has no std::thread / std::mutex, and the GDI
+// build still targets Windows XP (no condition variables), so this sticks to
+// threads, mutexes and counting semaphores. Storage is opaque to keep
+// windows.h out of the headers.
+
+typedef struct Mutex {
+  alignas(8) unsigned char storage[64];
+} Mutex;
+
+typedef struct Semaphore {
+  alignas(8) unsigned char storage[64];
+} Semaphore;
+
+typedef struct Thread {
+  alignas(8) unsigned char storage[16];
+} Thread;
+
+typedef void (*ThreadFunction)(void *user_data);
+
+void Mutex_Init(Mutex *mutex);
+void Mutex_Destroy(Mutex *mutex);
+void Mutex_Lock(Mutex *mutex);
+void Mutex_Unlock(Mutex *mutex);
+
+void Semaphore_Init(Semaphore *semaphore, int initial_count);
+void Semaphore_Destroy(Semaphore *semaphore);
+void Semaphore_Wait(Semaphore *semaphore);
+void Semaphore_Post(Semaphore *semaphore);
+
+bool Thread_Create(Thread *thread, ThreadFunction function, void *user_data);
+void Thread_Join(Thread *thread);
+
+// Gives up the CPU for about 'ms' milliseconds
+void Thread_Sleep(uint32_t ms);
+
+// Locks a mutex for the current scope
+class MutexLock {
+public:
+  explicit MutexLock(Mutex *mutex) : mutex(mutex) { Mutex_Lock(mutex); }
+  ~MutexLock() { Mutex_Unlock(mutex); }
+
+  MutexLock(const MutexLock &) = delete;
+  MutexLock &operator=(const MutexLock &) = delete;
+
+private:
+  Mutex *mutex;
+};
+
+#endif // THREAD_H
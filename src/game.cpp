@@ -1,64 +1,149 @@
 #include "game.h"
+#include "engine/animation.h"
+#include "engine/animationfileloader.h"
 #include "engine/bkgimagefileloader.h"
+#include "engine/collision.h"
 #include "engine/drawables.h"
 #include "engine/ecs.h"
 #include "engine/engine.h"
+#include "engine/font.h"
+#include "engine/fontfileloader.h"
+#include "engine/spatialaudio.h"
 #include "engine/spritefileloader.h"
 #include <iostream>
 #include <string.h>
 
-// Helper to log bounces (simplified port of on_bounce)
-static void on_bounce(Engine &engine) {
+// Helper to log bounces (simplified port of on_bounce). The boing follows
+// the ball that bounced, see UpdateAudioEmitters.
+static void on_bounce(Game &game, Engine &engine, EntityID id) {
   std::cout << "Bounce!" << std::endl;
-  engine.play_sound("./assets/snd/boing.wav");
+  game.bounce_count++;
+  VoiceHandle voice = engine.play_sound(ASSET_ID("./assets/snd/boing.wav"));
+  if (voice)
+    game.registry.set_audio_emitter(id, voice, 1.0f);
+}
+
+// --- Helper: Destroy an entity together with its drawable ---
+static void DestroyEntity(Game &game, Engine &engine, EntityID id) {
+  DrawableComponent *ref = game.registry.get_drawable_ref(id);
+  if (ref) {
+    // The last drawable moves into the gap; the registry follows it
+    if (ref->type == DrawableType::FOREGROUND)
+      engine.remove_foreground_drawable(ref->drawable_index);
+    else if (ref->type == DrawableType::WORLD)
+      engine.remove_world_drawable(ref->drawable_index);
+  }
+  game.registry.destroy_entity(id);
 }
 
 void Game::init(Engine &engine) {
   engine.set_registry(&registry);
 
   // 1. Initialize Arenas (Allocate the huge raw blocks once) & prepare lookup
-  // tables
-  sprite_arena.base_memory = (uint8_t *)malloc(SPRITE_ARENA_SIZE);
-  sprite_arena.capacity = SPRITE_ARENA_SIZE;
-  sprite_arena.bytes_used = 0;
-
-  bkg_arena.base_memory = (uint8_t *)malloc(BKG_ARENA_SIZE);
-  bkg_arena.capacity = BKG_ARENA_SIZE;
-  bkg_arena.bytes_used = 0;
-
-  memset(sprite_table, 0, sizeof(sprite_table));
-  memset(bkg_table, 0, sizeof(bkg_table));
-
-  // 2. Initialize lua scripting engine
-  if (scripting.init(this, &engine, &registry)) {
-    if (scripting.load_script("./assets/lua/init.lua")) {
-      scripting.run_script();
-    }
+  // registries
+  Arena_Init(&sprite_arena, "SpriteArena", SPRITE_ARENA_SIZE,
+             ARENA_BACKING_HUGEPAGES);
+  Arena_Init(&bkg_arena, "BkgImageArena", BKG_ARENA_SIZE, ARENA_BACKING_MMAP);
+
+  if (ShiftCache_Init(&shift_cache, &sprite_arena, SHIFT_CACHE_BUDGET,
+                      SHIFT_CACHE_SLOT_SIZE)) {
+    engine.set_shift_cache(&shift_cache);
+  }
+
+  AssetRegistry_Init(&sprite_registry, &sprite_arena, "SpriteRegistry",
+                     SPRITE_REGISTRY_CAPACITY, SPRITE_REGISTRY_NAMES_SIZE);
+  AssetRegistry_Init(&bkg_registry, &bkg_arena, "BkgImageRegistry",
+                     BKG_REGISTRY_CAPACITY, BKG_REGISTRY_NAMES_SIZE);
+
+  // Worker threads for Engine.LoadAsync; from now on the arenas are locked
+  AssetLoader_Init(&asset_loader, &sprite_arena, &bkg_arena, &sprite_registry,
+                   &bkg_registry, &engine);
+
+  // Files loaded from ./assets are tracked from here on and reloaded when
+  // they change on disk
+  HotReload_Init(&hot_reload, "./assets", &sprite_arena, &bkg_arena,
+                 &sprite_registry, &bkg_registry);
+  asset_loader.hot_reload = &hot_reload;
+
+  // 2. Mount the asset pack. Its assets live outside the arenas, so they
+  // survive level changes.
+  if (AssetPack_Open(&asset_pack, "./assets/assets.pack")) {
+    AssetPack_RegisterAssets(&asset_pack, &sprite_registry, &bkg_registry);
+    AssetPack_LoadSounds(&asset_pack, &engine);
+    hud_font = AssetPack_GetFont(&asset_pack, "hud");
+  }
+
+  // The HUD font and its static label outlive every level
+  if (!hud_font)
+    hud_font = LoadFontPBM(&sprite_arena, "./assets/fnt/hud.pbm", 8, 10, 0);
+  if (hud_font)
+    hud_title = GetStaticTextSprite(&sprite_registry, &sprite_arena, hud_font,
+                                    "MONOTEST");
+
+  // 3. Initialize lua scripting engine; the script runs with every level
+  if (scripting.init(this, &engine, &registry))
+    scripting.load_script("./assets/lua/init.lua");
+  last_update_ms = engine.get_time_ms();
+
+  // 4. The first level
+  start_level(engine);
+}
+
+void Game::start_level(Engine &engine) {
+  // Everything from here on belongs to the level
+  begin_level();
+
+  // 1. The script's entities and loads (TODO move the ones below there too)
+  scripting.run_script();
+
+  // 2. Level Assets
+  if (hud_title) {
+    EntityID entity = registry.create_entity();
+    ForegroundDrawable fd;
+    fd.sprite = hud_title;
+    fd.mask = hud_title; // Text sprites are their own mask
+    fd.sort_key = 0;
+    fd.flags = 0;
+    fd.owner_id = entity;
+    fd.x = 4;
+    fd.y = 4;
+    int index = engine.add_foreground_drawable(fd);
+    registry.set_drawable_ref(entity, DrawableType::FOREGROUND, index);
   }
 
-  // 3. Load Assets (TODO do all these in init.lua)
   // Preload Sound (note that we have a relatively dynamic sound loading system)
-  engine.load_sound("./assets/snd/boing.wav");
+  SoundID boing = engine.load_sound("./assets/snd/boing.wav");
+  // Fired on every wall hit: a few overlapping bounces are plenty
+  engine.set_sound_polyphony(boing, 4);
+  HotReload_Track(&hot_reload, "./assets/snd/boing.wav", HOT_RELOAD_SOUND,
+                  nullptr);
 
+  // Loose files are the fallback when the pack does not provide an asset
   Sprite *sprite_test =
-      LoadSpritePBM(&sprite_arena, "./assets/spr/testball.pbm");
-
-  if (sprite_test) {
-    RegisterSpriteAsAsset(sprite_table, SPRITE_TABLE_SIZE, "testball",
-                          sprite_test);
+      AssetRegistry_FindID(&sprite_registry, ASSET_ID("testball"));
+  if (!sprite_test) {
+    sprite_test = LoadInterleavedSpritePBM(
+        &sprite_arena, "./assets/spr/testball.pbm", SPRITE_MASK_SILHOUETTE);
+    HotReload_Track(&hot_reload, "./assets/spr/testball.pbm",
+                    HOT_RELOAD_SPRITE, sprite_test);
   }
 
-  Sprite *sprite_test2 = GetSprite(sprite_table, SPRITE_TABLE_SIZE, "testball");
+  if (sprite_test)
+    AssetRegistry_Add(&sprite_registry, "testball", sprite_test);
+
+  Sprite *sprite_test2 =
+      AssetRegistry_FindID(&sprite_registry, ASSET_ID("testball"));
   if (sprite_test2) {
     std::cout << "Successfully retrieved testball" << std::endl;
 
-    // Create multiple bouncing entities
-    for (int i = 0; i < 2; i++) {
+    // Create multiple bouncing entities, one more per level (up to 4)
+    int ball_count = 2 + level_number % 3;
+    for (int i = 0; i < ball_count; i++) {
       EntityID entity = registry.create_entity();
 
       ForegroundDrawable fd;
       fd.sprite = sprite_test2;
-      fd.mask = sprite_test2;
+      fd.mask = Sprite_Mask(sprite_test2);
       fd.sort_key = 0;
       fd.flags = DRAW_FLAG_INVERT;
       fd.owner_id = entity;
@@ -81,19 +166,136 @@ void Game::init(Engine &engine) {
       LoadBkgImagePBM(&bkg_arena, "./assets/bkg/testbackground.pbm");
 
   if (bkg_test) {
-    RegisterBkgImageAsAsset(bkg_table, BKG_TABLE_SIZE, "testbackground",
-                            bkg_test);
+    AssetRegistry_Add(&bkg_registry, "testbackground", bkg_test);
+    HotReload_Track(&hot_reload, "./assets/bkg/testbackground.pbm",
+                    HOT_RELOAD_BKGIMAGE, bkg_test);
   }
 
   BkgImage *bkg_test2 =
-      GetBkgImage(bkg_table, BKG_TABLE_SIZE, "testbackground");
+      AssetRegistry_FindID(&bkg_registry, ASSET_ID("testbackground"));
   if (bkg_test2) {
     std::cout << "Successfully retrieved testbackground" << std::endl;
     engine.set_active_background(bkg_test2);
   }
+
+  // A looping clip in the top-right corner; UpdateAnimators flips its frames
+  AnimationClip *spinner =
+      LoadAnimationStripPBM(&sprite_arena, "./assets/anim/spinner.pbm",
+                            nullptr, 32, 4, ANIM_FLAG_LOOP);
+  if (spinner) {
+    EntityID entity = registry.create_entity();
+    ForegroundDrawable fd;
+    fd.sprite = spinner->frames[0].sprite;
+    fd.mask = spinner->frames[0].mask;
+    fd.sort_key = 0;
+    fd.flags = 0;
+    fd.owner_id = entity;
+    fd.x = engine.get_width() - 36;
+    fd.y = 4;
+    int index = engine.add_foreground_drawable(fd);
+    registry.set_drawable_ref(entity, DrawableType::FOREGROUND, index);
+    registry.set_animator(entity, spinner);
+  }
+}
+
+void Game::begin_level() {
+  if (level_active) {
+    std::cerr << "Warning: begin_level called twice, keeping the first level"
+              << std::endl;
+    return;
+  }
+
+  level_sprite_checkpoint = Arena_Checkpoint(&sprite_arena);
+  level_bkg_checkpoint = Arena_Checkpoint(&bkg_arena);
+  level_active = true;
+}
+
+void Game::end_level(Engine &engine) {
+  if (!level_active)
+    return;
+
+  // Nothing may still be allocating from the level's memory. Draining also
+  // fires the last load callbacks, which may still touch entities.
+  AssetLoader_Drain(&asset_loader);
+
+  Arena_PrintStats(&sprite_arena);
+  Arena_PrintStats(&bkg_arena);
+
+  // 1. Drop the level's entities. Their drawables, animators, emitters and
+  // script behaviours go with them.
+  for (EntityID id = registry.id_limit(); id-- > 0;) {
+    if (registry.is_alive(id))
+      DestroyEntity(*this, engine, id);
+  }
+
+  // 2. Forget lookups into the memory that is about to be freed
+  uint8_t *sprite_begin = sprite_arena.base_memory + level_sprite_checkpoint;
+  uint8_t *sprite_end = sprite_arena.base_memory + sprite_arena.bytes_used;
+  AssetRegistry_RemoveInRange(&sprite_registry, sprite_begin, sprite_end);
+
+  uint8_t *bkg_begin = bkg_arena.base_memory + level_bkg_checkpoint;
+  uint8_t *bkg_end = bkg_arena.base_memory + bkg_arena.bytes_used;
+  AssetRegistry_RemoveInRange(&bkg_registry, bkg_begin, bkg_end);
+
+  HotReload_UntrackInRange(&hot_reload, sprite_begin, sprite_end);
+  HotReload_UntrackInRange(&hot_reload, bkg_begin, bkg_end);
+
+  // 3. Shifted variants may point at level sprites
+  if (engine.shift_cache == &shift_cache)
+    ShiftCache_Clear(&shift_cache);
+
+  BkgImage *active = engine.get_active_background();
+  if (active && Arena_OwnsSince(&bkg_arena, level_bkg_checkpoint, active))
+    engine.set_active_background(nullptr);
+
+  // 4. Free the level in O(1)
+  Arena_Rewind(&sprite_arena, level_sprite_checkpoint);
+  Arena_Rewind(&bkg_arena, level_bkg_checkpoint);
+  level_active = false;
+}
+
+void Game::change_level(Engine &engine) {
+  end_level(engine);
+  level_number++;
+  std::cout << "Level " << level_number + 1 << std::endl;
+  start_level(engine);
+}
+
+void Game::shutdown(Engine &engine) {
+  // Free the level the same way a level switch would
+  end_level(engine);
+
+  AssetLoader_Shutdown(&asset_loader);
+  HotReload_Shutdown(&hot_reload);
+  scripting.shutdown();
+  AssetPack_Close(&asset_pack);
+  Arena_Release(&sprite_arena);
+  Arena_Release(&bkg_arena);
 }
 
 void Game::update(Engine &engine) {
+  // Publish assets streamed in since the last frame (fires load callbacks)
+  AssetLoader_Pump(&asset_loader, 0);
+
+  // Apply edits made on disk, between frames
+  HotReload_Update(&hot_reload, engine.get_time_ms(), &engine, &scripting);
+
+  // An edited script starts the level over, so its previous run leaves no
+  // entities, behaviours or pending loads behind
+  if (scripting.reload_requested()) {
+    end_level(engine);
+    start_level(engine);
+  }
+
+  // Script hooks: on_update(dt) and entity behaviours, before physics so
+  // their velocity changes apply this frame
+  unsigned long now_ms = engine.get_time_ms();
+  scripting.update((now_ms - last_update_ms) / 1000.0f);
+  last_update_ms = now_ms;
+
+  // Advance sprite animations (swaps drawable sprite / mask pointers)
+  UpdateAnimators(registry, engine);
+
   // Canvas dimensions for collision
   int canvas_width = engine.get_width();
   int canvas_height = engine.get_height();
@@ -102,6 +304,8 @@ void Game::update(Engine &engine) {
   // A better ECS would allow iterating only active entities with specific
   // components. Since we don't have an iterator yet, we'll just check a safe
   // range of IDs. Assuming we didn't create more than 100 entities for now.
+  EntityID movers[100]; // Moved this frame, for the entity-vs-entity pass
+  int mover_count = 0;
   for (EntityID id = 0; id < 100; id++) {
     DisplaceableComponent *d = registry.get_displaceable(id);
     DrawableComponent *draw_ref = registry.get_drawable_ref(id);
@@ -125,26 +329,74 @@ void Game::update(Engine &engine) {
       if (d->x < 0) {
         d->x = 0;
         d->vx = -d->vx;
-        on_bounce(engine);
+        on_bounce(*this, engine, id);
       } else if (d->x + width > canvas_width) {
         d->x = canvas_width - width;
         d->vx = -d->vx;
-        on_bounce(engine);
+        on_bounce(*this, engine, id);
       }
 
       if (d->y < 0) {
         d->y = 0;
         d->vy = -d->vy;
-        on_bounce(engine);
+        on_bounce(*this, engine, id);
       } else if (d->y + height > canvas_height) {
         d->y = canvas_height - height;
         d->vy = -d->vy;
-        on_bounce(engine);
+        on_bounce(*this, engine, id);
       }
 
       // 2. Sync to Drawable
       fd->x = (int)d->x;
       fd->y = (int)d->y;
+      movers[mover_count++] = id;
+    }
+  }
+
+  // Entity vs entity: bounding boxes first, then the masks pixel by pixel
+  for (int i = 0; i < mover_count; i++) {
+    for (int j = i + 1; j < mover_count; j++) {
+      ForegroundDrawable *a = engine.get_foreground_drawable(
+          registry.get_drawable_ref(movers[i])->drawable_index);
+      ForegroundDrawable *b = engine.get_foreground_drawable(
+          registry.get_drawable_ref(movers[j])->drawable_index);
+      if (!DrawablesOverlap(*a, *b, nullptr))
+        continue;
+
+      // Equal masses: swap velocities, unless already moving apart
+      DisplaceableComponent *da = registry.get_displaceable(movers[i]);
+      DisplaceableComponent *db = registry.get_displaceable(movers[j]);
+      float dx = db->x - da->x;
+      float dy = db->y - da->y;
+      if (dx * (db->vx - da->vx) + dy * (db->vy - da->vy) >= 0)
+        continue;
+
+      float vx = da->vx;
+      float vy = da->vy;
+      da->vx = db->vx;
+      da->vy = db->vy;
+      db->vx = vx;
+      db->vy = vy;
+      on_bounce(*this, engine, movers[i]);
     }
   }
+
+  // Bounce sounds follow their balls, heard from the middle of the screen
+  AudioListener listener;
+  listener.x = canvas_width * 0.5f;
+  listener.y = canvas_height * 0.5f;
+  listener.range = (float)canvas_width;
+  listener.pan_width = canvas_width * 0.5f;
+  UpdateAudioEmitters(registry, engine, listener);
+
+  // Enough bounces: free this level and build the next one, between frames
+  if (bounce_count >= (level_number + 1) * BOUNCES_PER_LEVEL)
+    change_level(engine);
+
+  // HUD: counters that change every bounce, drawn as immediate text
+  if (hud_font)
+    engine.queue_text(hud_font, 4, canvas_height - 14,
+                      engine.frame_format("Level %d  Bounces: %d",
+                                          level_number + 1, bounce_count),
+                      0);
 }
\ No newline at end of file
@@ -1,12 +1,16 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "engine/assetloader.h"
+#include "engine/assetpack.h"
 #include "engine/bkgimagearena.h"
-#include "engine/bkgimageassetentry.h"
+#include "engine/bkgimageregistry.h"
 #include "engine/ecs.h"
+#include "engine/hotreload.h"
 #include "engine/scripting.h"
+#include "engine/shiftcache.h"
 #include "engine/spritearena.h"
-#include "engine/spriteassetentry.h"
+#include "engine/spriteregistry.h"
 #include <vector>
 
 const int CANVAS_WIDTH = 480;
@@ -16,8 +20,20 @@ const int SCALE = 2;
 const size_t SPRITE_ARENA_SIZE = 32 * 1024 * 1024; // 32 MB
 const size_t BKG_ARENA_SIZE = 8 * 1024 * 1024;     // 8 MB
 
-#define SPRITE_TABLE_SIZE 4096
-#define BKG_TABLE_SIZE 128
+// Pre-shifted sprite variants, carved out of the sprite arena.
+// A 2 KB slot holds a 64x64 sprite + mask shifted (3 words * 64 rows * 2).
+const size_t SHIFT_CACHE_BUDGET = 1024 * 1024; // 1 MB
+const size_t SHIFT_CACHE_SLOT_SIZE = 2048;
+
+// Asset registries, carved out of the arenas below every level checkpoint.
+// The name pools hold the interned names (about 32 bytes per entry).
+#define SPRITE_REGISTRY_CAPACITY 4096
+#define SPRITE_REGISTRY_NAMES_SIZE (SPRITE_REGISTRY_CAPACITY * 32)
+#define BKG_REGISTRY_CAPACITY 128
+#define BKG_REGISTRY_NAMES_SIZE (BKG_REGISTRY_CAPACITY * 32)
+
+// The next level starts after this many more bounces
+const int BOUNCES_PER_LEVEL = 40;
 
 class Engine;
 
@@ -27,19 +43,53 @@ struct Game {
   SpriteArena sprite_arena;
   BkgImageArena bkg_arena;
 
+  ShiftCache shift_cache;
+
+  // Baked assets, memory-mapped at startup (optional, see 'make pack')
+  AssetPack asset_pack;
+
+  // Background streaming into the arenas and registries below
+  AssetLoader asset_loader;
+
+  // Reloads changed files below ./assets (Linux, development only)
+  HotReload hot_reload;
+
   // ECS Registry
   Registry registry;
 
-  // Asset Lookup Tables
+  // Asset Lookup
+
+  SpriteRegistry sprite_registry;
+  BkgImageRegistry bkg_registry;
 
-  SpriteAssetEntry sprite_table[SPRITE_TABLE_SIZE];
-  BkgImageAssetEntry bkg_table[BKG_TABLE_SIZE];
+  // HUD
+  BitmapFont *hud_font = nullptr; // From the asset pack, or loaded at init
+  Sprite *hud_title = nullptr;    // Static label, shown by every level
+  int bounce_count = 0;
 
   // Scripting Engine
   ScriptManager scripting;
+  unsigned long last_update_ms = 0; // For the scripts' dt
+
+  // Level lifetime. Everything loaded into the arenas between begin_level
+  // and end_level is freed at once by rewinding them. A level owns every
+  // entity: end_level destroys them (and their drawables) first.
+  ArenaCheckpoint level_sprite_checkpoint = 0;
+  ArenaCheckpoint level_bkg_checkpoint = 0;
+  bool level_active = false;
+  int level_number = 0;
 
   void init(Engine &engine);
   void update(Engine &engine);
+  void shutdown(Engine &engine);
+
+  void begin_level();
+  void end_level(Engine &engine);
+  // begin_level, then fills the level: the script first, then the game's
+  // own entities
+  void start_level(Engine &engine);
+  // Frees the current level and starts the next one
+  void change_level(Engine &engine);
 };
 
 #endif // GAME_H
@@ -59,6 +59,7 @@ int main(int /*argc*/, char ** /*argv*/) {
   // Start loop
   engine->start(game);
 
+  game.shutdown(*engine);
   delete engine;
   return 0;
 }
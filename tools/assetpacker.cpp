@@ -0,0 +1,284 @@
+// Offline asset packer: bakes the assets listed in a manifest into one
+// memory-mappable pack (see src/engine/assetpack.h).
+//
+// Usage: assetpacker <manifest> <output.pack>
+//
+// Manifest lines (paths are relative to the manifest, '#' starts a comment):
+//   sprite <name> <file.pbm> [spans | silhouette | outline [interleaved]]
+//   sheet  <name> <file.pbm> [spans]
+//   bkg    <name> <file.pbm>
+//   font   <name> <file.pbm> <glyph_width> <glyph_height> [fixed_advance]
+//   sound  <name> <file>
+//
+// 'silhouette' and 'outline' bake the sprite with its mask attached (see
+// LoadMaskedSpritePBM), or woven into its rows with 'interleaved'. A sheet
+// is a multi-image PBM; each image becomes a sprite named <name>_0,
+// <name>_1, ... in file order.
+//
+// Images go through the engine's own loaders, so the baked blobs are
+// byte-for-byte what the game would have built in its arenas.
+
+#include "engine/arena.h"
+#include "engine/assetpack.h"
+#include "engine/bkgimagefileloader.h"
+#include "engine/fontfileloader.h"
+#include "engine/spritefileloader.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const size_t SCRATCH_ARENA_SIZE = 64 * 1024 * 1024; // 64 MB
+static const int MAX_SHEET_SPRITES = 1024;
+
+struct PackedAsset {
+  std::string name;
+  uint16_t type;
+  uint64_t name_hash;
+  const uint8_t *data; // Into the scratch arena (images and fonts)
+  size_t size;
+  std::vector<uint8_t> file_bytes; // Sounds
+
+  const uint8_t *bytes() const {
+    return file_bytes.empty() ? data : file_bytes.data();
+  }
+};
+
+// --- Helper: Blob sizes, matching what the loaders allocate ---
+static size_t BkgImageBlobSize(const BkgImage *b) {
+  return sizeof(BkgImage) + (size_t)b->width_in_words * 4 * b->height;
+}
+
+static size_t FontBlobSize(const BitmapFont *f) {
+  return sizeof(BitmapFont) +
+         (size_t)f->glyph_count * f->glyph_height * sizeof(uint32_t);
+}
+
+static bool ReadWholeFile(const std::string &path, std::vector<uint8_t> &out) {
+  std::ifstream fs(path.c_str(), std::ios::binary | std::ios::ate);
+  if (!fs)
+    return false;
+  out.resize((size_t)fs.tellg());
+  fs.seekg(0);
+  fs.read((char *)out.data(), out.size());
+  return (bool)fs;
+}
+
+static const char *TypeName(uint16_t type) {
+  switch (type) {
+  case ASSET_TYPE_SPRITE:
+    return "sprite";
+  case ASSET_TYPE_BKGIMAGE:
+    return "bkg";
+  case ASSET_TYPE_FONT:
+    return "font";
+  default:
+    return "sound";
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <manifest> <output.pack>"
+              << std::endl;
+    return 1;
+  }
+
+  std::string manifest_path = argv[1];
+  std::string base_dir;
+  size_t slash = manifest_path.find_last_of("/\\");
+  if (slash != std::string::npos)
+    base_dir = manifest_path.substr(0, slash + 1);
+
+  std::ifstream manifest(manifest_path.c_str());
+  if (!manifest) {
+    std::cerr << "Error: Could not open manifest " << manifest_path
+              << std::endl;
+    return 1;
+  }
+
+  Arena scratch;
+  if (!Arena_Init(&scratch, "Packer arena", SCRATCH_ARENA_SIZE,
+                  ARENA_BACKING_MMAP))
+    return 1;
+
+  // 1. Load every asset listed in the manifest
+  std::vector<PackedAsset> assets;
+  std::string line;
+  int line_number = 0;
+  while (std::getline(manifest, line)) {
+    line_number++;
+    size_t comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    std::istringstream words(line);
+    std::string kind, name, file;
+    if (!(words >> kind))
+      continue;
+    if (!(words >> name >> file)) {
+      std::cerr << manifest_path << ":" << line_number
+                << ": expected '<type> <name> <file>'" << std::endl;
+      return 1;
+    }
+    std::string path = base_dir + file;
+
+    PackedAsset asset;
+    asset.name = name;
+    asset.name_hash = AssetHash(name.c_str());
+    asset.data = nullptr;
+    asset.size = 0;
+
+    if (kind == "sprite") {
+      std::string option, layout;
+      words >> option >> layout;
+      uint32_t mode = option == "outline" ? SPRITE_MASK_OUTLINE
+                                          : SPRITE_MASK_SILHOUETTE;
+      Sprite *s;
+      if ((option == "silhouette" || option == "outline") &&
+          layout == "interleaved") {
+        s = LoadInterleavedSpritePBM(&scratch, path.c_str(), mode);
+      } else if (option == "silhouette" || option == "outline") {
+        s = LoadMaskedSpritePBM(&scratch, path.c_str(), mode);
+      } else if (option == "spans") {
+        s = LoadSpritePBMWithSpans(&scratch, path.c_str());
+      } else {
+        s = LoadSpritePBM(&scratch, path.c_str());
+      }
+      asset.type = ASSET_TYPE_SPRITE;
+      asset.data = (const uint8_t *)s;
+      asset.size = s ? Sprite_TotalBytes(s) : 0;
+    } else if (kind == "sheet") {
+      std::string option;
+      bool spans = (words >> option) && option == "spans";
+      static Sprite *sheet[MAX_SHEET_SPRITES];
+      int count = LoadSpriteSheetPBM(&scratch, path.c_str(), sheet,
+                                     MAX_SHEET_SPRITES, spans);
+      if (count == 0)
+        return 1; // The loader already said why
+
+      // Every image becomes a sprite of its own
+      for (int i = 0; i < count; i++) {
+        PackedAsset frame = asset;
+        frame.name = name + "_" + std::to_string(i);
+        frame.name_hash = AssetHash(frame.name.c_str());
+        frame.type = ASSET_TYPE_SPRITE;
+        frame.data = (const uint8_t *)sheet[i];
+        frame.size = Sprite_TotalBytes(sheet[i]);
+        assets.push_back(frame);
+      }
+      continue;
+    } else if (kind == "bkg") {
+      BkgImage *b = LoadBkgImagePBM(&scratch, path.c_str());
+      asset.type = ASSET_TYPE_BKGIMAGE;
+      asset.data = (const uint8_t *)b;
+      asset.size = b ? BkgImageBlobSize(b) : 0;
+    } else if (kind == "font") {
+      int glyph_width = 0, glyph_height = 0, fixed_advance = 0;
+      words >> glyph_width >> glyph_height >> fixed_advance;
+      BitmapFont *f = LoadFontPBM(&scratch, path.c_str(), glyph_width,
+                                  glyph_height, fixed_advance);
+      asset.type = ASSET_TYPE_FONT;
+      asset.data = (const uint8_t *)f;
+      asset.size = f ? FontBlobSize(f) : 0;
+    } else if (kind == "sound") {
+      asset.type = ASSET_TYPE_SOUND;
+      if (!ReadWholeFile(path, asset.file_bytes) || asset.file_bytes.empty()) {
+        std::cerr << "Error: Could not read sound " << path << std::endl;
+        return 1;
+      }
+      asset.size = asset.file_bytes.size();
+    } else {
+      std::cerr << manifest_path << ":" << line_number
+                << ": unknown asset type '" << kind << "'" << std::endl;
+      return 1;
+    }
+
+    if (asset.size == 0)
+      return 1; // The loader already said why
+    assets.push_back(asset);
+  }
+
+  // 2. Sort by hash, the order AssetPack_Find searches in
+  std::sort(assets.begin(), assets.end(),
+            [](const PackedAsset &a, const PackedAsset &b) {
+              if (a.name_hash != b.name_hash)
+                return a.name_hash < b.name_hash;
+              return a.type < b.type;
+            });
+
+  for (size_t i = 1; i < assets.size(); i++) {
+    if (assets[i].name_hash == assets[i - 1].name_hash &&
+        assets[i].type == assets[i - 1].type &&
+        assets[i].name == assets[i - 1].name) {
+      std::cerr << "Error: " << TypeName(assets[i].type) << " '"
+                << assets[i].name << "' is listed twice" << std::endl;
+      return 1;
+    }
+  }
+
+  // 3. Lay out header, index, names, then the aligned blobs
+  AssetPackHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = ASSET_PACK_MAGIC;
+  header.version = ASSET_PACK_VERSION;
+  header.entry_count = (uint32_t)assets.size();
+  header.names_offset = (uint32_t)(sizeof(AssetPackHeader) +
+                                   assets.size() * sizeof(AssetPackEntry));
+
+  std::vector<AssetPackEntry> entries(assets.size());
+  std::string names;
+  for (size_t i = 0; i < assets.size(); i++) {
+    memset(&entries[i], 0, sizeof(AssetPackEntry));
+    entries[i].name_hash = assets[i].name_hash;
+    entries[i].type = assets[i].type;
+    entries[i].name_offset = (uint32_t)names.size();
+    entries[i].data_size = (uint32_t)assets[i].size;
+    names += assets[i].name;
+    names += '\0';
+  }
+  header.names_size = (uint32_t)names.size();
+
+  size_t offset = header.names_offset + names.size();
+  for (size_t i = 0; i < assets.size(); i++) {
+    offset = (offset + ASSET_PACK_ALIGN - 1) & ~(size_t)(ASSET_PACK_ALIGN - 1);
+    entries[i].data_offset = (uint32_t)offset;
+    offset += assets[i].size;
+  }
+  header.file_size = offset;
+
+  // 4. Write it out
+  FILE *out = fopen(argv[2], "wb");
+  if (!out) {
+    std::cerr << "Error: Could not create " << argv[2] << std::endl;
+    return 1;
+  }
+
+  static const uint8_t zeros[ASSET_PACK_ALIGN] = {0};
+  fwrite(&header, sizeof(header), 1, out);
+  fwrite(entries.data(), sizeof(AssetPackEntry), entries.size(), out);
+  fwrite(names.data(), 1, names.size(), out);
+
+  size_t written = header.names_offset + names.size();
+  for (size_t i = 0; i < assets.size(); i++) {
+    fwrite(zeros, 1, entries[i].data_offset - written, out);
+    fwrite(assets[i].bytes(), 1, assets[i].size, out);
+    written = entries[i].data_offset + assets[i].size;
+  }
+
+  bool ok = (ferror(out) == 0);
+  ok = (fclose(out) == 0) && ok;
+  if (!ok) {
+    std::cerr << "Error: Failed writing " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cout << "Packed " << assets.size() << " assets into " << argv[2]
+            << " (" << header.file_size << " bytes)" << std::endl;
+  Arena_Release(&scratch);
+  return 0;
+}
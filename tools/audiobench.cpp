@@ -0,0 +1,113 @@
+// Offline mixer benchmark: keeps a given number of voices playing through
+// the engine's own audio path (AudioSystem_InitOffline, see
+// src/engine/audio.h) and times how long mixing takes, with no device and
+// no audio thread in the way.
+//
+// Usage: audiobench [voices] [seconds] [sample_rate]
+//
+// Half the voices play a mono sound and half a stereo one, each with its
+// own volume and pan; whenever a voice ends another is started, so the
+// count stays level. Time advances in 16 ms game ticks, like the headless
+// engine. Built with a larger voice pool than the game (see the Makefile's
+// 'audiobench' target) so 256+ voices fit.
+
+#include "engine/audio.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+static const int TICK_MS = 16;
+static const int SOUND_SECONDS = 2;
+
+// --- Helper: A synthetic sound, cached like a decoded file ---
+static SoundID MakeSound(AudioSystem *audio, const char *name,
+                         uint32_t channels, uint32_t sample_rate) {
+  SoundData data;
+  data.channels = channels;
+  data.frame_count = (uint64_t)sample_rate * SOUND_SECONDS;
+  data.samples = (int16_t *)ma_malloc(
+      (size_t)data.frame_count * channels * sizeof(int16_t), NULL);
+  if (!data.samples)
+    return 0;
+
+  // A sawtooth per channel, enough to keep the mixer honest
+  for (uint64_t i = 0; i < data.frame_count; i++) {
+    for (uint32_t c = 0; c < channels; c++)
+      data.samples[i * channels + c] = (int16_t)((i * (c + 3) * 97) % 8192);
+  }
+  return AudioSystem_CacheDecoded(audio, name, &data);
+}
+
+static double NowMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+int main(int argc, char **argv) {
+  int voices = argc > 1 ? atoi(argv[1]) : 256;
+  int seconds = argc > 2 ? atoi(argv[2]) : 10;
+  uint32_t rate = argc > 3 ? (uint32_t)atoi(argv[3]) : 0;
+  if (voices < 1 || voices > AUDIO_MAX_VOICES || seconds < 1) {
+    std::cerr << "Usage: " << argv[0] << " [voices (1-" << AUDIO_MAX_VOICES
+              << ")] [seconds] [sample_rate]" << std::endl;
+    return 1;
+  }
+
+  AudioSystem *audio = new AudioSystem();
+  if (!AudioSystem_InitOffline(audio, ".", rate)) {
+    delete audio;
+    return 1;
+  }
+  rate = AudioSystem_SampleRate(audio);
+
+  // 1. Two sounds, each allowed the whole pool
+  SoundID sounds[2] = {MakeSound(audio, "mono", 1, rate),
+                       MakeSound(audio, "stereo", 2, rate)};
+  for (int i = 0; i < 2; i++)
+    AudioSystem_SetPolyphony(audio, sounds[i], voices);
+
+  // 2. Run the ticks, timing only the mix
+  std::vector<float> block((size_t)rate * AUDIO_CHANNELS);
+  uint64_t mixed = 0;
+  uint64_t voice_frames = 0;
+  uint64_t triggers = 0;
+  double mix_ms = 0;
+  int ticks = seconds * 1000 / TICK_MS;
+
+  for (int tick = 0; tick < ticks; tick++) {
+    uint64_t now_ms = (uint64_t)tick * TICK_MS;
+    AudioSystem_Update(audio, now_ms);
+
+    while (audio->active_count < voices) {
+      int n = (int)(triggers++ % 16);
+      VoiceHandle voice = AudioSystem_Play(audio, sounds[n & 1]);
+      AudioSystem_SetVolume(audio, voice, 0.25f + n / 32.0f);
+      AudioSystem_SetPan(audio, voice, n / 8.0f - 1.0f);
+    }
+
+    uint64_t target = (now_ms + TICK_MS) * rate / 1000;
+    uint32_t count = (uint32_t)(target - mixed);
+    double start = NowMs();
+    AudioSystem_Render(audio, block.data(), count);
+    mix_ms += NowMs() - start;
+    mixed += count;
+    voice_frames += (uint64_t)audio->active_count * count;
+  }
+
+  // 3. Report
+  double audio_ms = mixed * 1000.0 / rate;
+  printf("%d voices, %u Hz, %.1f s of audio mixed in %.2f ms\n", voices,
+         rate, audio_ms / 1000.0, mix_ms);
+  printf("  %.2f%% of real time, %.1f ns per output frame, "
+         "%.2f ns per voice frame, %llu triggers\n",
+         100.0 * mix_ms / audio_ms, mix_ms * 1e6 / mixed,
+         mix_ms * 1e6 / voice_frames, (unsigned long long)triggers);
+
+  AudioSystem_Shutdown(audio);
+  delete audio;
+  return 0;
+}